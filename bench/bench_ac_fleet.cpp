@@ -0,0 +1,79 @@
+#include "ac_fleet.hpp"
+#include "bench_utils.hpp"
+#include "simd.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_ACS = 10000;
+/// @brief A building: 16 units per room.
+constexpr size_t ACS_PER_ROOM = 16;
+/// @brief One simulated second per round.
+constexpr size_t ROUNDS = 1000;
+constexpr size_t REPS = 3;
+constexpr uint32_t SESSION_MINS = 24 * 60;
+
+uint32_t powerOf(size_t i) { return 500 + 100 * static_cast<uint32_t>(i % 16); }
+
+} // namespace
+
+/// Every unit runs a day-long session so all of them are active for the whole benchmark.
+void benchAcFleet() {
+    std::printf(
+        "\n== AC update, %zu units x %zu one-second steps, SIMD backend %s ==\n",
+        NUM_ACS,
+        ROUNDS,
+        Simd::K_BACKEND
+    );
+    constexpr size_t ops = NUM_ACS * ROUNDS;
+    double scale = SimClock::getTimeScale();
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+
+    {
+        // One room: `RealAC` only knows `Device::s_room`.
+        Device::loginRoom(std::make_shared<Room>(25.f));
+        std::vector<std::unique_ptr<RealAC>> acs;
+        DeviceData command;
+        command.op_id = DeviceOpId::eRealAcOpenForMins;
+        command.dint = SESSION_MINS;
+        command.dstring = "eMid";
+        for (size_t i = 0; i < NUM_ACS; i++) {
+            acs.push_back(std::make_unique<RealAC>(powerOf(i)));
+            command.dbool = i % 2 == 0;
+            acs.back()->operate(&command);
+            acs.back()->clearRecords();
+        }
+        auto result = Bench::measure("RealAC::timeTravel(0) per unit", ops, REPS, [&] {
+            for (size_t round = 0; round < ROUNDS; round++) {
+                SimClock::sleepFor(std::chrono::seconds(1));
+                for (auto& ac : acs) {
+                    Bench::doNotOptimize(ac->timeTravel(0));
+                }
+            }
+        });
+        Bench::report(result);
+    }
+    {
+        AcFleet fleet;
+        fleet.reserve(NUM_ACS);
+        for (size_t i = 0; i < NUM_ACS; i++) {
+            if (i % ACS_PER_ROOM == 0)
+                fleet.addRoom(25.f);
+            auto unit = fleet.addUnit(static_cast<AcFleet::RoomId>(i / ACS_PER_ROOM), powerOf(i));
+            fleet.openForMins(unit, SESSION_MINS, i % 2 == 0, AcFleet::Mode::eMid);
+        }
+        auto result = Bench::measure("AcFleet::advance(), SoA + SIMD", ops, REPS, [&] {
+            for (size_t round = 0; round < ROUNDS; round++) {
+                fleet.advance(1.f);
+            }
+        });
+        Bench::doNotOptimize(fleet.getRoomTemp(0));
+        Bench::report(result);
+        double updates_per_us = static_cast<double>(ops) / result.ms / 1e3;
+        Bench::reportValue(result.name, "M AC-updates/s", updates_per_us);
+    }
+
+    SimClock::setTimeScale(scale);
+}
@@ -0,0 +1,72 @@
+#include "air_fryer.hpp"
+#include "bench_utils.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_REQUESTS = 2000;
+/// @brief A kitchen busy enough that the basket is the bottleneck.
+constexpr uint32_t ARRIVAL_EVERY_MIN = 8;
+constexpr float BASKET_VOLUME = 5.f;
+
+/// @brief Same request stream for every policy: 0.5 to 4 liters, 5 to 25 minutes.
+std::vector<std::shared_ptr<DeviceData>> makeRequests() {
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<float> volume(0.5f, 4.f);
+    std::uniform_int_distribution<int> minutes(5, 25);
+    std::vector<std::shared_ptr<DeviceData>> requests;
+    for (size_t i = 0; i < NUM_REQUESTS; i++) {
+        auto data = std::make_shared<DeviceData>();
+        data->op_id = DeviceOpId::eAirFryerCook;
+        data->mf_id = DeviceMfId::eNormal;
+        data->dfloat = volume(rng);
+        data->dint = minutes(rng);
+        data->cmd_id = static_cast<uint32_t>(i + 1);
+        requests.push_back(data);
+    }
+    return requests;
+}
+
+void runPolicy(
+    const char* name,
+    AirFryer::Admission admission,
+    const std::vector<std::shared_ptr<DeviceData>>& requests
+) {
+    AirFryer fryer(BASKET_VOLUME);
+    fryer.setAdmission(admission);
+    fryer.resetStats();
+    auto start = SimClock::now();
+    for (const auto& data : requests) {
+        fryer.operate(data.get());
+        fryer.timeTravel(ARRIVAL_EVERY_MIN);
+        fryer.clearRecords();
+    }
+    fryer.timeTravel(0);
+    auto stats = fryer.getStats();
+    double hours = std::chrono::duration<double, std::ratio<3600>>(SimClock::now() - start).count();
+    Bench::reportValue(name, "items/h", static_cast<double>(stats.cooked) / hours);
+    Bench::reportValue(name, "utilization %", 100.0 * stats.utilization);
+    Bench::reportValue(name, "mean wait min", static_cast<double>(stats.mean_wait_min));
+    Bench::reportValue(name, "max wait min", static_cast<double>(stats.max_wait_min));
+}
+
+} // namespace
+
+/// Simulated throughput rather than wall time: what the admission policy buys is food per hour.
+void benchAirFryer() {
+    std::printf(
+        "\n== AirFryer admission, %zu requests every %u min, %.0f L basket ==\n",
+        NUM_REQUESTS,
+        ARRIVAL_EVERY_MIN,
+        static_cast<double>(BASKET_VOLUME)
+    );
+    double scale = SimClock::getTimeScale();
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    auto requests = makeRequests();
+    runPolicy("FIFO", AirFryer::Admission::eFifo, requests);
+    runPolicy("first-fit decreasing", AirFryer::Admission::eFirstFitDecreasing, requests);
+    SimClock::setTimeScale(scale);
+}
@@ -0,0 +1,112 @@
+#include "air_fryer.hpp"
+#include "bench_utils.hpp"
+#include "real_ac.hpp"
+#include "smart_manager.hpp"
+#include "washer_dryer.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_DEVICES = 4096;
+constexpr size_t PENDING_PER_DEVICE = 4;
+constexpr size_t REPS = 5;
+
+DeviceData makeCommand(DeviceOpId op_id, float dfloat, int dint) {
+    DeviceData data = {};
+    data.op_id = op_id;
+    data.mf_id = DeviceMfId::eNormal;
+    data.dfloat = dfloat;
+    data.dint = dint;
+    data.dstring = "eMid";
+    return data;
+}
+
+/// @brief A busy home: fryers with items in the basket and one queued, washer-dryers with jobs
+/// waiting in both bins, ACs halfway through a session, and commands waiting for `operate()`.
+/// Devices are driven directly with `operate()` only, since every `malfunction()` writes text.
+void populateHome(SmartManager& manager) {
+    for (size_t i = 0; i < NUM_DEVICES; i++) {
+        std::shared_ptr<Device> device;
+        DeviceOpId pending_op;
+        switch (i % 3) {
+        case 0: {
+            device = std::make_shared<AirFryer>(5.f);
+            for (float volume : {2.f, 2.f, 3.f}) {
+                auto data = makeCommand(DeviceOpId::eAirFryerCook, volume, 20);
+                device->operate(&data);
+            }
+            pending_op = DeviceOpId::eAirFryerCook;
+            break;
+        }
+        case 1: {
+            device = std::make_shared<WasherDryer>(10.f);
+            for (int minutes : {40, 30, 20}) {
+                auto data = makeCommand(DeviceOpId::eWashDryerCombo, 5.f, minutes);
+                device->operate(&data);
+            }
+            pending_op = DeviceOpId::eWashDryerDryOnly;
+            break;
+        }
+        default: {
+            device = std::make_shared<RealAC>(2000);
+            auto data = makeCommand(DeviceOpId::eRealAcOpenForMins, 0.f, 30);
+            device->operate(&data);
+            pending_op = DeviceOpId::eRealAcOpenForMins;
+            break;
+        }
+        }
+        device->clearRecords();
+        auto id = *manager.addDevice(std::move(device));
+        DataList pending;
+        for (size_t c = 0; c < PENDING_PER_DEVICE; c++) {
+            pending.push_back(manager.createData());
+            *pending.back() = makeCommand(pending_op, 1.f, 10);
+        }
+        manager.addMultipleData(id, std::move(pending));
+        manager.addTravleTime(id, 15);
+    }
+}
+
+} // namespace
+
+void benchCheckpoint() {
+    std::printf(
+        "\n== Checkpoint, %zu devices with %zu pending commands each ==\n",
+        NUM_DEVICES,
+        PENDING_PER_DEVICE
+    );
+    double scale = SimClock::getTimeScale();
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    Device::loginRoom(std::make_shared<Room>(25.f));
+    auto path = (std::filesystem::temp_directory_path() / "smart_home_bench.ckpt").string();
+
+    SmartManager home;
+    populateHome(home);
+    auto save = Bench::measure("saveCheckpoint(), write + fsync + rename", NUM_DEVICES, REPS, [&] {
+        Bench::doNotOptimize(home.saveCheckpoint(path));
+    });
+    Bench::report(save);
+
+    // One fresh manager per repetition, destroyed after timing: tearing down isn't restoring.
+    std::vector<std::unique_ptr<SmartManager>> managers;
+    for (size_t i = 0; i < REPS; i++) {
+        managers.push_back(std::make_unique<SmartManager>());
+    }
+    size_t rep = 0;
+    auto restore = Bench::measure("restoreCheckpoint(), mmap + rebuild", NUM_DEVICES, REPS, [&] {
+        Bench::doNotOptimize(managers[rep++]->restoreCheckpoint(path));
+    });
+    Bench::report(restore);
+    Bench::reportValue(
+        save.name, "bytes", static_cast<double>(std::filesystem::file_size(path))
+    );
+    Bench::reportValue(
+        restore.name, "devices restored", static_cast<double>(managers.back()->getNumDevices())
+    );
+    std::filesystem::remove(path);
+    SimClock::setTimeScale(scale);
+}
@@ -0,0 +1,76 @@
+#include "bench_utils.hpp"
+#include "config_loader.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_DEVICES = 1000;
+constexpr size_t COMMANDS_PER_DEVICE = 1000;
+constexpr size_t REPS = 3;
+
+/// @brief A building's worth of devices, every one with a full command list.
+std::string makeConfig() {
+    std::string text;
+    text.reserve(NUM_DEVICES * COMMANDS_PER_DEVICE * 40);
+    for (size_t i = 0; i < NUM_DEVICES; i++) {
+        switch (i % 3) {
+        case 0:
+            text += "device eAirFryer 5.0\ntravel 0\n";
+            for (size_t c = 0; c < COMMANDS_PER_DEVICE; c++) {
+                text += "cmd eAirFryerCook eNormal 0.5 ";
+                text += std::to_string(5 + c % 20);
+                text += '\n';
+            }
+            break;
+        case 1:
+            text += "device eWasherDryer 10\ntravel 30\n";
+            for (size_t c = 0; c < COMMANDS_PER_DEVICE; c++) {
+                text += c % 2 == 0 ? "cmd eWashDryerCombo eNormal 6.5 40\n"
+                                   : "cmd eWashDryerDryOnly eBroken 3.25 25\n";
+            }
+            break;
+        default:
+            text += "device eRealAC 2000\ntravel 0\n";
+            for (size_t c = 0; c < COMMANDS_PER_DEVICE; c++) {
+                text += "cmd eRealAcOpenForMins eNormal 0 15 1 eMid  # comment\n";
+            }
+            break;
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+void benchConfig() {
+    constexpr size_t ops = NUM_DEVICES * COMMANDS_PER_DEVICE;
+    std::printf(
+        "\n== Config loading, %zu devices x %zu commands ==\n", NUM_DEVICES, COMMANDS_PER_DEVICE
+    );
+    auto path = (std::filesystem::temp_directory_path() / "smart_home_bench.cfg").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << makeConfig();
+    }
+
+    // One fresh manager per repetition, destroyed after timing: tearing down isn't loading.
+    std::vector<std::unique_ptr<SmartManager>> managers;
+    for (size_t i = 0; i < REPS; i++) {
+        managers.push_back(std::make_unique<SmartManager>());
+    }
+    Config::LoadStats stats;
+    size_t rep = 0;
+    auto result = Bench::measure("Config::loadFile(), mmap + from_chars", ops, REPS, [&] {
+        stats = *Config::loadFile(path, *managers[rep++]);
+    });
+    Bench::report(result);
+    Bench::reportValue(result.name, "commands", static_cast<double>(stats.commands));
+    Bench::reportValue(result.name, "errors", static_cast<double>(stats.errors));
+    Bench::reportValue(result.name, "M commands/s", static_cast<double>(ops) / result.ms / 1e3);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,161 @@
+#include "bench_utils.hpp"
+#include "data_pool.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Count heap allocations, so the report can show allocations per command next to the timing.
+// Only a thread inside an `AllocCounter` counts: every other suite in this executable goes through
+// these operators too, and pays a thread-local check instead of a shared atomic.
+namespace {
+
+thread_local bool t_counting = false;
+thread_local size_t t_heap_allocs = 0;
+
+void* allocate(size_t size) {
+    if (t_counting)
+        t_heap_allocs++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+/// @brief Over-allocates and keeps the `malloc()` pointer right before the aligned block, which
+/// works on every platform, unlike `std::aligned_alloc()`.
+void* allocateAligned(size_t size, std::align_val_t align) {
+    auto alignment = static_cast<size_t>(align);
+    void* raw = allocate(size + alignment + sizeof(void*));
+    if (raw == nullptr)
+        return nullptr;
+    auto address = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+    auto* aligned = reinterpret_cast<void*>((address + alignment - 1) & ~(alignment - 1));
+    static_cast<void**>(aligned)[-1] = raw;
+    return aligned;
+}
+
+void freeAligned(void* p) noexcept {
+    if (p != nullptr)
+        std::free(static_cast<void**>(p)[-1]);
+}
+
+/// @brief Counts this thread's heap allocations while alive.
+class AllocCounter {
+public:
+    AllocCounter() {
+        t_heap_allocs = 0;
+        t_counting = true;
+    }
+    ~AllocCounter() { t_counting = false; }
+    size_t count() const { return t_heap_allocs; }
+};
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (void* p = allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(size_t size, std::align_val_t align) {
+    if (void* p = allocateAligned(size, align))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t align) { return operator new(size, align); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    freeAligned(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    freeAligned(p);
+}
+
+namespace {
+
+constexpr size_t NUM_COMMANDS = 100000;
+constexpr size_t ROUNDS = 4;
+constexpr size_t REPS = 5;
+
+/// @brief What `populateData()` and `SmartManager::operate()` do to a command: create it, fill it
+/// in, keep it until the round ends, then drop the whole batch.
+template <typename MakeData>
+void runRounds(MakeData&& make_data, DataPool* pool) {
+    std::vector<std::shared_ptr<DeviceData>> batch;
+    batch.reserve(NUM_COMMANDS);
+    for (size_t round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < NUM_COMMANDS; i++) {
+            auto data = make_data();
+            data->op_id = DeviceOpId::eAirFryerCook;
+            data->dint = static_cast<int>(i);
+            data->dfloat = 2.0f;
+            batch.push_back(std::move(data));
+        }
+        Bench::doNotOptimize(batch.back()->dint);
+        batch.clear();
+        if (pool)
+            pool->reset();
+    }
+}
+
+void reportAllocs(const Bench::Result& result, size_t allocs) {
+    Bench::report(result);
+    Bench::reportValue(
+        result.name,
+        "allocs/command",
+        static_cast<double>(allocs) / static_cast<double>(NUM_COMMANDS * ROUNDS)
+    );
+}
+
+} // namespace
+
+void benchDataPool() {
+    std::printf("\n== DeviceData allocation, %zu commands x %zu rounds ==\n", NUM_COMMANDS, ROUNDS);
+    constexpr size_t ops = NUM_COMMANDS * ROUNDS;
+
+    {
+        auto make = [] { return std::make_shared<DeviceData>(); };
+        size_t allocs = 0;
+        {
+            AllocCounter counter;
+            runRounds(make, nullptr);
+            allocs = counter.count();
+        }
+        auto result = Bench::measure("make_shared", ops, REPS, [&] { runRounds(make, nullptr); });
+        reportAllocs(result, allocs);
+    }
+    {
+        DataPool pool;
+        auto make = [&pool] { return pool.make(); };
+        // The first round grows the slabs; steady state is what SmartManager sees every operate().
+        runRounds(make, &pool);
+        size_t allocs = 0;
+        {
+            AllocCounter counter;
+            runRounds(make, &pool);
+            allocs = counter.count();
+        }
+        auto result = Bench::measure("DataPool", ops, REPS, [&] { runRounds(make, &pool); });
+        reportAllocs(result, allocs);
+    }
+}
@@ -0,0 +1,97 @@
+#include "bench_utils.hpp"
+#include "device_data.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_CALLS = 1 << 22;
+constexpr size_t REPS = 5;
+
+// Both hierarchies have the shape of `AirFryer`: `SmartManager` calls the virtual operate() and
+// malfunction(), operate() forwards to a private helper. Only the way data is passed differs.
+
+/// @brief The former API: every hop copies the shared_ptr, an atomic increment and decrement.
+class OwningDevice {
+public:
+    virtual ~OwningDevice() = default;
+    virtual void operate(std::shared_ptr<DeviceData> data) = 0;
+    virtual void malfunction(std::shared_ptr<DeviceData> data) = 0;
+};
+
+class OwningFryer final : public OwningDevice {
+public:
+    void operate(std::shared_ptr<DeviceData> data) override {
+        if (data->op_id == DeviceOpId::eAirFryerCook)
+            cook(data);
+    }
+    void malfunction(std::shared_ptr<DeviceData> data) override { m_sum += data->dint; }
+
+    int m_sum = 0;
+
+private:
+    [[gnu::noinline]] void cook(std::shared_ptr<DeviceData> data) { m_sum += data->dint; }
+};
+
+/// @brief The current API: devices borrow a `DeviceData*`, ownership stays with the manager.
+class HandleDevice {
+public:
+    virtual ~HandleDevice() = default;
+    virtual void operate(DeviceData* data) = 0;
+    virtual void malfunction(DeviceData* data) = 0;
+};
+
+class HandleFryer final : public HandleDevice {
+public:
+    void operate(DeviceData* data) override {
+        if (data->op_id == DeviceOpId::eAirFryerCook)
+            cook(data);
+    }
+    void malfunction(DeviceData* data) override { m_sum += data->dint; }
+
+    int m_sum = 0;
+
+private:
+    [[gnu::noinline]] void cook(DeviceData* data) { m_sum += data->dint; }
+};
+
+} // namespace
+
+void benchDispatch() {
+    std::printf("\n== DeviceData passing, operate() + malfunction() per call ==\n");
+
+    std::vector<std::shared_ptr<DeviceData>> data(64);
+    for (auto& d : data) {
+        d = std::make_shared<DeviceData>();
+        d->op_id = DeviceOpId::eAirFryerCook;
+        d->dint = 1;
+    }
+
+    {
+        std::unique_ptr<OwningDevice> device = std::make_unique<OwningFryer>();
+        Bench::doNotOptimize(device);
+        auto result = Bench::measure("shared_ptr by value", NUM_CALLS, REPS, [&] {
+            for (size_t i = 0; i < NUM_CALLS; i++) {
+                const auto& d = data[i % data.size()];
+                device->operate(d);
+                device->malfunction(d);
+            }
+        });
+        Bench::report(result);
+        Bench::doNotOptimize(static_cast<OwningFryer*>(device.get())->m_sum);
+    }
+    {
+        std::unique_ptr<HandleDevice> device = std::make_unique<HandleFryer>();
+        Bench::doNotOptimize(device);
+        auto result = Bench::measure("DeviceData* handle", NUM_CALLS, REPS, [&] {
+            for (size_t i = 0; i < NUM_CALLS; i++) {
+                auto* d = data[i % data.size()].get();
+                device->operate(d);
+                device->malfunction(d);
+            }
+        });
+        Bench::report(result);
+        Bench::doNotOptimize(static_cast<HandleFryer*>(device.get())->m_sum);
+    }
+}
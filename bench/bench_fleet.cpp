@@ -0,0 +1,76 @@
+#include "bench_utils.hpp"
+#include "device_fleet.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_DEVICES = 3000;
+constexpr size_t ROUNDS = 100;
+constexpr size_t REPS = 5;
+
+/// @brief Commands whose whole operate() is cheap and text-free, so dispatch dominates:
+/// a song, a cleanup and an oversized dry load that is rejected on the spot.
+std::vector<std::shared_ptr<DeviceData>> makeCommands() {
+    std::vector<std::shared_ptr<DeviceData>> commands(3);
+    for (auto& command : commands) {
+        command = std::make_shared<DeviceData>();
+    }
+    commands[0]->op_id = DeviceOpId::eSing;
+    commands[1]->op_id = DeviceOpId::eAirFryerClean;
+    commands[2]->op_id = DeviceOpId::eWashDryerDryOnly;
+    commands[2]->dfloat = 1e6f;
+    return commands;
+}
+
+} // namespace
+
+/// Only operate() is timed: every malfunction branch, even `eNormal`, logs text, which would drown
+/// the cost of the call itself.
+void benchFleet() {
+    std::printf("\n== Device dispatch, %zu mixed devices x %zu rounds ==\n", NUM_DEVICES, ROUNDS);
+    constexpr size_t ops = NUM_DEVICES * ROUNDS;
+    auto commands = makeCommands();
+
+    {
+        // Interleaved types, so neither path gets a perfectly predicted branch.
+        std::vector<std::shared_ptr<Device>> devices;
+        devices.reserve(NUM_DEVICES);
+        for (size_t i = 0; i < NUM_DEVICES; i += 3) {
+            devices.push_back(std::make_shared<DemoDevice>("Bench"));
+            devices.push_back(std::make_shared<AirFryer>());
+            devices.push_back(std::make_shared<WasherDryer>());
+        }
+        auto result = Bench::measure("shared_ptr<Device>, virtual", ops, REPS, [&] {
+            for (size_t round = 0; round < ROUNDS; round++) {
+                for (size_t i = 0; i < devices.size(); i++) {
+                    devices[i]->operate(commands[i % 3].get());
+                    devices[i]->clearRecords();
+                }
+            }
+        });
+        Bench::report(result);
+    }
+    {
+        DeviceFleet fleet;
+        fleet.reserve(NUM_DEVICES);
+        for (size_t i = 0; i < NUM_DEVICES; i += 3) {
+            fleet.emplace<DemoDevice>("Bench");
+            fleet.emplace<AirFryer>();
+            fleet.emplace<WasherDryer>();
+        }
+        auto result = Bench::measure("DeviceFleet, std::visit", ops, REPS, [&] {
+            for (size_t round = 0; round < ROUNDS; round++) {
+                for (DeviceId id = 0; id < fleet.size(); id++) {
+                    fleet.visit(id, [&](auto& device) {
+                        using T = std::remove_cvref_t<decltype(device)>;
+                        device.T::operate(commands[id % 3].get());
+                        device.clearRecords();
+                    });
+                }
+            }
+        });
+        Bench::report(result);
+    }
+}
@@ -0,0 +1,138 @@
+#include "bench_utils.hpp"
+#include "mpmc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_COMMANDS = 1 << 18;
+constexpr size_t CAPACITY = 4096;
+constexpr size_t PRODUCER_COUNTS[] = {1, 2, 4, 8, 16, 32, 64};
+
+/// @brief What `SmartManager::submit()` enqueues, minus the shared_ptr.
+struct Command {
+    uint32_t id = 0;
+    void* data = nullptr;
+};
+
+/// @brief Baseline with the same interface: a deque behind a mutex.
+class LockedQueue {
+public:
+    explicit LockedQueue(size_t capacity) : m_capacity(capacity) {}
+
+    bool tryPush(Command&& command) {
+        std::lock_guard lock(m_mutex);
+        if (m_items.size() == m_capacity)
+            return false;
+        m_items.push_back(command);
+        return true;
+    }
+    bool tryPop(Command& out) {
+        std::lock_guard lock(m_mutex);
+        if (m_items.empty())
+            return false;
+        out = m_items.front();
+        m_items.pop_front();
+        return true;
+    }
+
+private:
+    const size_t m_capacity;
+    std::mutex m_mutex;
+    std::deque<Command> m_items;
+};
+
+struct IngressStats {
+    double ms;
+    /// @brief Per-submission latency, including retries while the queue is full.
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+};
+
+/// @brief `num_producers` threads submit `NUM_COMMANDS` in total while one consumer drains, like
+/// sensors and apps feeding a running `SmartManager`.
+template <typename Queue>
+IngressStats runIngress(size_t num_producers) {
+    using namespace std::chrono;
+    Queue queue(CAPACITY);
+    size_t per_producer = NUM_COMMANDS / num_producers;
+    std::vector<std::vector<uint32_t>> latencies(num_producers);
+    std::atomic<bool> go = false;
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < num_producers; p++) {
+        producers.emplace_back([&, p] {
+            auto& samples = latencies[p];
+            samples.reserve(per_producer);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < per_producer; i++) {
+                auto start = steady_clock::now();
+                while (!queue.tryPush(Command{static_cast<uint32_t>(p), nullptr})) {
+                    std::this_thread::yield();
+                }
+                auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+                samples.push_back(static_cast<uint32_t>(elapsed.count()));
+            }
+        });
+    }
+
+    auto start = steady_clock::now();
+    go.store(true, std::memory_order_release);
+    size_t received = 0;
+    Command command;
+    while (received < per_producer * num_producers) {
+        if (queue.tryPop(command))
+            received++;
+        else
+            std::this_thread::yield();
+    }
+    double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    std::vector<uint32_t> all;
+    all.reserve(received);
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    auto percentile = [&all](double q) -> uint64_t {
+        auto nth = all.begin() + static_cast<ptrdiff_t>(q * static_cast<double>(all.size() - 1));
+        std::nth_element(all.begin(), nth, all.end());
+        return *nth;
+    };
+    return {ms, percentile(0.5), percentile(0.99), percentile(0.999)};
+}
+
+/// @brief One run, not the best of several: the latency percentiles are the point, and they come
+/// from every submission of that run.
+void reportIngress(const char* queue, size_t num_producers, const IngressStats& stats) {
+    auto name = std::format("{}, {} producers", queue, num_producers);
+    Bench::report({name, NUM_COMMANDS, stats.ms});
+    Bench::reportValue(name, "p50 ns", static_cast<double>(stats.p50_ns));
+    Bench::reportValue(name, "p99 ns", static_cast<double>(stats.p99_ns));
+    Bench::reportValue(name, "p99.9 ns", static_cast<double>(stats.p999_ns));
+}
+
+} // namespace
+
+void benchIngress() {
+    std::printf(
+        "\n== Command ingress, %zu commands, capacity %zu, one consumer ==\n", NUM_COMMANDS, CAPACITY
+    );
+    for (size_t num_producers : PRODUCER_COUNTS) {
+        reportIngress("MpmcQueue", num_producers, runIngress<MpmcQueue<Command>>(num_producers));
+        reportIngress("mutex + deque", num_producers, runIngress<LockedQueue>(num_producers));
+    }
+}
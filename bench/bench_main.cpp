@@ -0,0 +1,123 @@
+#include "bench_utils.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Suite {
+    const char* name;
+    void (*run)();
+};
+
+/// @brief Every benchmark, named after its file, in the order they run.
+constexpr Suite K_SUITES[] = {
+    {"scheduler", benchScheduler},
+    {"data_pool", benchDataPool},
+    {"dispatch", benchDispatch},
+    {"fleet", benchFleet},
+    {"ingress", benchIngress},
+    {"thermal", benchThermal},
+    {"ac_fleet", benchAcFleet},
+    {"air_fryer", benchAirFryer},
+    {"washer_dryer", benchWasherDryer},
+    {"manager", benchManager},
+    {"config", benchConfig},
+    {"checkpoint", benchCheckpoint},
+    {"replay", benchReplay},
+};
+
+void writeJsonString(std::FILE* file, std::string_view str) {
+    std::fputc('"', file);
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            std::fputc('\\', file);
+        std::fputc(c, file);
+    }
+    std::fputc('"', file);
+}
+
+/// @brief One object per reported result and per reported value, plus what the numbers depend on,
+/// so results of two builds can be compared entry by entry.
+bool writeJson(const char* path) {
+    std::FILE* file = std::fopen(path, "w");
+    if (file == nullptr)
+        return false;
+#ifdef NDEBUG
+    constexpr bool ndebug = true;
+#else
+    constexpr bool ndebug = false;
+#endif
+    std::fprintf(file, "{\n  \"compiler\": ");
+    writeJsonString(file, __VERSION__);
+    std::fprintf(file, ",\n  \"ndebug\": %s,\n  \"simd\": ", ndebug ? "true" : "false");
+    writeJsonString(file, Simd::K_BACKEND);
+    std::fprintf(file, ",\n  \"results\": [");
+    const auto& entries = Bench::reported();
+    for (size_t i = 0; i < entries.size(); i++) {
+        const auto& [suite, result] = entries[i];
+        std::fprintf(file, "%s\n    {\"suite\": ", i == 0 ? "" : ",");
+        writeJsonString(file, suite);
+        std::fprintf(file, ", \"name\": ");
+        writeJsonString(file, result.name);
+        std::fprintf(
+            file,
+            ", \"ops\": %zu, \"ms\": %.6f, \"ns_per_op\": %.3f}",
+            result.ops,
+            result.ms,
+            result.nsPerOp()
+        );
+    }
+    std::fprintf(file, "\n  ],\n  \"values\": [");
+    const auto& values = Bench::reportedValues();
+    for (size_t i = 0; i < values.size(); i++) {
+        const auto& [suite, name, metric, value] = values[i];
+        std::fprintf(file, "%s\n    {\"suite\": ", i == 0 ? "" : ",");
+        writeJsonString(file, suite);
+        std::fprintf(file, ", \"name\": ");
+        writeJsonString(file, name);
+        std::fprintf(file, ", \"metric\": ");
+        writeJsonString(file, metric);
+        std::fprintf(file, ", \"value\": %.9g}", value);
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+/// Usage: SmartHomeBench [--json results.json] [suite...]
+/// With no suite named, every one runs.
+int main(int argc, char** argv) {
+    const char* json_path = nullptr;
+    std::vector<std::string_view> selected;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_path = argv[++i];
+        else
+            selected.push_back(argv[i]);
+    }
+    for (auto name : selected) {
+        auto matches = [name](const Suite& suite) { return suite.name == name; };
+        if (std::ranges::none_of(K_SUITES, matches)) {
+            std::fprintf(stderr, "Unknown benchmark %s\n", name.data());
+            return 1;
+        }
+    }
+
+    for (const auto& suite : K_SUITES) {
+        if (!selected.empty() && std::ranges::find(selected, suite.name) == selected.end())
+            continue;
+        Bench::currentSuite() = suite.name;
+        suite.run();
+    }
+
+    if (json_path != nullptr && !writeJson(json_path)) {
+        std::fprintf(stderr, "Cannot write %s\n", json_path);
+        return 1;
+    }
+    return 0;
+}
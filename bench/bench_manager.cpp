@@ -0,0 +1,105 @@
+#include "air_fryer.hpp"
+#include "bench_utils.hpp"
+#include "real_ac.hpp"
+#include "smart_manager.hpp"
+#include "washer_dryer.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <memory>
+
+namespace {
+
+constexpr size_t DEVICE_COUNTS[] = {16, 256, 4096};
+constexpr size_t COMMANDS_PER_DEVICE = 4;
+constexpr size_t REPS = 5;
+
+void addDevices(SmartManager& manager, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        std::shared_ptr<Device> device;
+        switch (i % 4) {
+        case 0:
+            device = std::make_shared<DemoDevice>("DemoBot");
+            break;
+        case 1:
+            device = std::make_shared<AirFryer>(5.f);
+            break;
+        case 2:
+            device = std::make_shared<WasherDryer>(10.f);
+            break;
+        default:
+            device = std::make_shared<RealAC>(1000);
+            break;
+        }
+        auto id = *manager.addDevice(std::move(device));
+        manager.addTravleTime(id, 30);
+    }
+}
+
+/// @brief One round's worth of commands, the kind each device accepts.
+void addCommands(SmartManager& manager, size_t count) {
+    for (DeviceId id = 0; id < count; id++) {
+        DataList commands;
+        for (size_t c = 0; c < COMMANDS_PER_DEVICE; c++) {
+            auto& data = *commands.emplace_back(manager.createData());
+            data.mf_id = DeviceMfId::eNormal;
+            data.dbool = false;
+            data.dstring = "eLow";
+            switch (id % 4) {
+            case 0:
+                data.op_id = c % 2 == 0 ? DeviceOpId::eHello : DeviceOpId::eSing;
+                break;
+            case 1:
+                data.op_id = DeviceOpId::eAirFryerCook;
+                data.dfloat = 1.f;
+                data.dint = 5;
+                break;
+            case 2:
+                data.op_id = DeviceOpId::eWashDryerWashOnly;
+                data.dfloat = 2.f;
+                data.dint = 5;
+                break;
+            default:
+                data.op_id = DeviceOpId::eRealAcOpenForMins;
+                data.dint = 5;
+                break;
+            }
+        }
+        manager.addMultipleData(id, std::move(commands));
+    }
+}
+
+} // namespace
+
+/// End to end on the virtual clock: sessions, commands, time travel and the text log, which goes
+/// to a scratch file instead of the terminal.
+void benchManager() {
+    std::printf(
+        "\n== SmartManager::operate(), %zu commands per device ==\n", COMMANDS_PER_DEVICE
+    );
+    double scale = SimClock::getTimeScale();
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    Device::loginRoom(std::make_shared<Room>(25.f));
+    auto log_path = (std::filesystem::temp_directory_path() / "smart_home_bench.log").string();
+    std::FILE* sink = std::fopen(log_path.c_str(), "w");
+
+    for (size_t count : DEVICE_COUNTS) {
+        SmartManager manager;
+        addDevices(manager, count);
+        Log::setOutput(sink, sink);
+        auto result = Bench::measure(
+            std::format("{} devices", count),
+            count * COMMANDS_PER_DEVICE,
+            REPS,
+            [&] { addCommands(manager, count); },
+            [&] { manager.operate(); }
+        );
+        Log::setOutput(stdout, stderr);
+        Bench::report(result);
+    }
+
+    std::fclose(sink);
+    std::filesystem::remove(log_path);
+    SimClock::setTimeScale(scale);
+}
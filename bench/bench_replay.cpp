@@ -0,0 +1,119 @@
+#include "air_fryer.hpp"
+#include "bench_utils.hpp"
+#include "real_ac.hpp"
+#include "smart_manager.hpp"
+#include "washer_dryer.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_DEVICES = 64;
+constexpr size_t NUM_ROUNDS = 200;
+constexpr size_t REPS = 3;
+
+std::shared_ptr<DeviceData> makeCommand(SmartManager& manager, size_t device, size_t round) {
+    auto data = manager.createData();
+    data->mf_id = DeviceMfId::eNormal;
+    data->dbool = round % 2 == 0;
+    data->dstring = "eLow";
+    switch (device % 4) {
+    case 0:
+        data->op_id = round % 2 == 0 ? DeviceOpId::eHello : DeviceOpId::eSing;
+        break;
+    case 1:
+        data->op_id = DeviceOpId::eAirFryerCook;
+        data->dfloat = 1.f;
+        data->dint = 5 + static_cast<int>(round % 10);
+        break;
+    case 2:
+        data->op_id = DeviceOpId::eWashDryerWashOnly;
+        data->dfloat = 2.f;
+        data->dint = 20;
+        break;
+    default:
+        data->op_id = DeviceOpId::eRealAcOpenForMins;
+        data->dint = 10;
+        break;
+    }
+    return data;
+}
+
+/// @brief A day of a busy home on the virtual clock: every round each device gets a command and
+/// 15 minutes pass.
+void recordSession(const std::string& path) {
+    SmartManager manager;
+    manager.startRecording(path);
+    std::vector<DeviceId> ids;
+    for (size_t i = 0; i < NUM_DEVICES; i++) {
+        std::shared_ptr<Device> device;
+        switch (i % 4) {
+        case 0:
+            device = std::make_shared<DemoDevice>("DemoBot");
+            break;
+        case 1:
+            device = std::make_shared<AirFryer>(5.f);
+            break;
+        case 2:
+            device = std::make_shared<WasherDryer>(10.f);
+            break;
+        default:
+            device = std::make_shared<RealAC>(1000);
+            break;
+        }
+        ids.push_back(*manager.addDevice(std::move(device)));
+        manager.addTravleTime(ids.back(), 15);
+    }
+    for (size_t round = 0; round < NUM_ROUNDS; round++) {
+        for (size_t i = 0; i < NUM_DEVICES; i++) {
+            manager.addSingleData(ids[i], makeCommand(manager, i, round));
+        }
+        manager.operate();
+    }
+    manager.stopRecording();
+}
+
+} // namespace
+
+void benchReplay() {
+    constexpr size_t ops = NUM_DEVICES * NUM_ROUNDS;
+    std::printf(
+        "\n== Replay, %zu devices x %zu rounds on the virtual clock ==\n", NUM_DEVICES, NUM_ROUNDS
+    );
+    double scale = SimClock::getTimeScale();
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    Device::loginRoom(std::make_shared<Room>(25.f));
+    auto path = (std::filesystem::temp_directory_path() / "smart_home_bench.rec").string();
+    auto log_path = (std::filesystem::temp_directory_path() / "smart_home_bench.log").string();
+
+    // The device log is part of replaying, but not something to print here.
+    std::FILE* sink = std::fopen(log_path.c_str(), "w");
+    Log::setOutput(sink, sink);
+    recordSession(path);
+
+    std::vector<std::unique_ptr<SmartManager>> managers;
+    for (size_t i = 0; i < REPS; i++) {
+        managers.push_back(std::make_unique<SmartManager>());
+    }
+    size_t rep = 0;
+    bool ok = true;
+    auto result = Bench::measure("SmartManager::replay(), text log", ops, REPS, [&] {
+        ok = managers[rep++]->replay(path) && ok;
+    });
+    Log::setOutput(stdout, stderr);
+    std::fclose(sink);
+
+    Bench::report(result);
+    Bench::reportValue(
+        result.name, "recording bytes", static_cast<double>(std::filesystem::file_size(path))
+    );
+    Bench::reportValue(result.name, "M commands/s", static_cast<double>(ops) / result.ms / 1e3);
+    if (!ok)
+        std::printf("%-48s replay FAILED\n", result.name.c_str());
+    std::filesystem::remove(path);
+    std::filesystem::remove(log_path);
+    SimClock::setTimeScale(scale);
+}
@@ -0,0 +1,90 @@
+#include "bench_utils.hpp"
+#include "thread_pool.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_DEVICES = 4096;
+constexpr size_t REPS = 5;
+/// @brief Cost of a light session, e.g. `DemoDevice::hello`.
+constexpr uint32_t LIGHT_UNITS = 200;
+/// @brief A heavy session, e.g. a `WasherDryer` combo chaining wash and dry, is 100x a light one.
+constexpr uint32_t HEAVY_UNITS = 100 * LIGHT_UNITS;
+
+/// @brief Stand-in for one device session of `units` CPU work.
+void spinWork(uint32_t units) {
+    uint64_t acc = units;
+    for (uint32_t i = 0; i < units; i++) {
+        acc = acc * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    Bench::doNotOptimize(acc);
+}
+
+/// @brief Devices are usually registered type by type, so the heavy ones sit together.
+std::vector<uint32_t> makeWorkload() {
+    std::vector<uint32_t> costs(NUM_DEVICES, LIGHT_UNITS);
+    std::fill(costs.begin(), costs.begin() + NUM_DEVICES / 8, HEAVY_UNITS);
+    return costs;
+}
+
+/// @brief Baseline: each thread gets a contiguous block of devices up front.
+void runStatic(const std::vector<uint32_t>& costs, size_t num_threads) {
+    std::vector<std::thread> threads;
+    size_t chunk = (costs.size() + num_threads - 1) / num_threads;
+    for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&costs, chunk, t] {
+            size_t end = std::min(costs.size(), (t + 1) * chunk);
+            for (size_t i = t * chunk; i < end; i++) {
+                spinWork(costs[i]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void runPool(TaskPool& pool, const std::vector<uint32_t>& costs) {
+    for (auto cost : costs) {
+        pool.submit([cost] { spinWork(cost); });
+    }
+    pool.wait();
+}
+
+} // namespace
+
+void benchScheduler() {
+    auto costs = makeWorkload();
+    size_t num_threads = std::max(2u, std::thread::hardware_concurrency());
+    std::printf(
+        "\n== Device session scheduling, %zu sessions (1/8 heavy), %zu threads ==\n",
+        NUM_DEVICES,
+        num_threads
+    );
+
+    {
+        auto result = Bench::measure("static partition", costs.size(), REPS, [&] {
+            runStatic(costs, num_threads);
+        });
+        Bench::report(result);
+    }
+    {
+        ThreadPool pool(num_threads);
+        auto result = Bench::measure("ThreadPool, shared queue", costs.size(), REPS, [&] {
+            runPool(pool, costs);
+        });
+        Bench::report(result);
+    }
+    {
+        WorkStealingPool pool(num_threads);
+        auto result = Bench::measure("WorkStealingPool", costs.size(), REPS, [&] {
+            runPool(pool, costs);
+        });
+        Bench::report(result);
+        Bench::reportValue(result.name, "steals", static_cast<double>(pool.getStealCount()));
+    }
+}
@@ -0,0 +1,44 @@
+#include "bench_utils.hpp"
+#include "simd.hpp"
+#include "thermal_grid.hpp"
+
+#include <string>
+
+namespace {
+
+constexpr uint32_t SIZES[] = {64, 128, 256, 512};
+/// @brief Roughly 64M cell updates per size, so small grids aren't timer noise.
+constexpr size_t CELL_STEPS = size_t{1} << 26;
+constexpr size_t REPS = 3;
+
+/// @brief A 25-degree room with two ACs in opposite corners, one heating and one cooling.
+ThermalGrid makeRoom(uint32_t size, ThermalGrid::Kernel kernel) {
+    ThermalGrid grid(size, size, 25.f, 1.f);
+    grid.setSourceRate(grid.addSource(size / 8, size / 8), 0.5f);
+    grid.setSourceRate(grid.addSource(size - 1 - size / 8, size - 1 - size / 8), -0.5f);
+    grid.setKernel(kernel);
+    return grid;
+}
+
+} // namespace
+
+void benchThermal() {
+    std::printf("\n== Thermal grid diffusion, SIMD backend %s ==\n", Simd::K_BACKEND);
+    for (uint32_t size : SIZES) {
+        size_t cells = size_t{size} * size;
+        size_t steps = CELL_STEPS / cells;
+        for (auto kernel : {ThermalGrid::Kernel::eScalar, ThermalGrid::Kernel::eSimd}) {
+            auto grid = makeRoom(size, kernel);
+            std::string name = std::to_string(size) + "x" + std::to_string(size) +
+                               (kernel == ThermalGrid::Kernel::eSimd ? " SIMD" : " scalar") +
+                               ", per cell-step";
+            auto result = Bench::measure(std::move(name), cells * steps, REPS, [&] {
+                for (size_t i = 0; i < steps; i++) {
+                    grid.step(ThermalGrid::K_MAX_STABLE_STEP);
+                }
+            });
+            Bench::doNotOptimize(grid.getMeanTemp());
+            Bench::report(result);
+        }
+    }
+}
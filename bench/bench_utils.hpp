@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+/// @brief Minimal timing helpers shared by every benchmark file.
+namespace Bench {
+
+struct Result {
+    std::string name;
+    /// @brief Operations performed per repetition, e.g. commands or device sessions.
+    size_t ops;
+    /// @brief Wall time of the fastest repetition.
+    double ms;
+
+    double nsPerOp() const { return ops == 0 ? 0.0 : ms * 1e6 / static_cast<double>(ops); }
+};
+
+/// @brief Keep `value` alive so the optimizer can't drop the work producing it.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// @brief Run `fn` `reps` times and keep the fastest, which is the least noisy.
+template <typename F>
+Result measure(std::string name, size_t ops, size_t reps, F&& fn) {
+    using namespace std::chrono;
+    double best = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < reps; i++) {
+        auto start = steady_clock::now();
+        fn();
+        best = std::min(best, duration<double, std::milli>(steady_clock::now() - start).count());
+    }
+    return {std::move(name), ops, best};
+}
+
+/// @brief Like `measure()`, but `setup()` runs untimed before every repetition, e.g. to refill
+/// what `fn()` consumes.
+template <typename S, typename F>
+Result measure(std::string name, size_t ops, size_t reps, S&& setup, F&& fn) {
+    using namespace std::chrono;
+    double best = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < reps; i++) {
+        setup();
+        auto start = steady_clock::now();
+        fn();
+        best = std::min(best, duration<double, std::milli>(steady_clock::now() - start).count());
+    }
+    return {std::move(name), ops, best};
+}
+
+/// @brief A reported result and the benchmark entry point it came from.
+struct Entry {
+    std::string suite;
+    Result result;
+};
+
+/// @brief A non-timing number a benchmark measured, e.g. a latency percentile or a throughput in
+/// simulated time.
+struct Value {
+    std::string suite;
+    /// @brief The `Result` it belongs to, or the row it describes.
+    std::string name;
+    /// @brief What `value` is, with its unit, e.g. "p99 ns" or "items/h".
+    std::string metric;
+    double value;
+};
+
+/// @brief Entry point running right now, set by bench_main.cpp.
+inline std::string& currentSuite() {
+    static std::string s_suite;
+    return s_suite;
+}
+
+/// @brief Everything `report()` printed so far, for the JSON output.
+inline std::vector<Entry>& reported() {
+    static std::vector<Entry> s_entries;
+    return s_entries;
+}
+
+/// @brief Everything `reportValue()` printed so far, for the JSON output.
+inline std::vector<Value>& reportedValues() {
+    static std::vector<Value> s_values;
+    return s_values;
+}
+
+inline void report(const Result& result) {
+    reported().push_back({currentSuite(), result});
+    std::printf(
+        "%-48s %12zu ops %12.3f ms %12.1f ns/op\n",
+        result.name.c_str(),
+        result.ops,
+        result.ms,
+        result.nsPerOp()
+    );
+}
+
+/// @brief Print and keep a number that isn't a wall time, next to the `report()` row it explains.
+inline void reportValue(std::string name, std::string metric, double value) {
+    // Counts print as integers, rates and averages with 3 decimals.
+    int precision = value == std::trunc(value) ? 0 : 3;
+    std::printf("%-48s %12.*f %s\n", name.c_str(), precision, value, metric.c_str());
+    reportedValues().push_back({currentSuite(), std::move(name), std::move(metric), value});
+}
+
+} // namespace Bench
+
+// One entry point per benchmark file, called from bench_main.cpp.
+void benchScheduler();
+void benchDataPool();
+void benchDispatch();
+void benchFleet();
+void benchIngress();
+void benchThermal();
+void benchAcFleet();
+void benchAirFryer();
+void benchConfig();
+void benchCheckpoint();
+void benchReplay();
+void benchManager();
+void benchWasherDryer();
@@ -0,0 +1,48 @@
+#include "bench_utils.hpp"
+#include "washer_dryer.hpp"
+
+#include <cstdio>
+#include <format>
+
+namespace {
+
+constexpr size_t NUM_JOBS = 1 << 16;
+constexpr size_t BIN_CAPACITIES[] = {8, 64, 512};
+constexpr int JOB_MINUTES = 30;
+constexpr size_t REPS = 5;
+
+} // namespace
+
+/// Combo jobs fill the wash bin, then one time travel settles them all: each job washes, is handed
+/// to the dryer's bin and dries. Only `operate()` and `timeTravel()` run, since `malfunction()`
+/// always writes text.
+void benchWasherDryer() {
+    std::printf("\n== WasherDryer queue, %zu combo jobs ==\n", NUM_JOBS);
+    double scale = SimClock::getTimeScale();
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+
+    DeviceData data = {};
+    data.op_id = DeviceOpId::eWashDryerCombo;
+    data.mf_id = DeviceMfId::eNormal;
+    data.dfloat = 1.f;
+    data.dint = JOB_MINUTES;
+
+    for (size_t capacity : BIN_CAPACITIES) {
+        WasherDryer washer_dryer(10.f, capacity);
+        // Enough for the last job of a full bin to get through the dryer too.
+        auto drain_minutes = static_cast<uint32_t>((capacity + 1) * JOB_MINUTES);
+        auto name = std::format("bin capacity {}", capacity);
+        auto result = Bench::measure(std::move(name), NUM_JOBS, REPS, [&] {
+            for (size_t done = 0; done < NUM_JOBS; done += capacity) {
+                for (size_t i = 0; i < capacity; i++) {
+                    data.cmd_id = static_cast<uint32_t>(done + i);
+                    washer_dryer.operate(&data);
+                }
+                washer_dryer.timeTravel(drain_minutes);
+                washer_dryer.clearRecords();
+            }
+        });
+        Bench::report(result);
+    }
+    SimClock::setTimeScale(scale);
+}
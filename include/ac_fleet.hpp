@@ -0,0 +1,64 @@
+#pragma once
+
+#include "real_ac.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief Building-scale store of air conditioners with the same physics as `RealAC`, laid out as
+/// structure of arrays so one pass updates thousands of units and the rooms they sit in.
+///
+/// A `RealAC` rereads the clock and recomputes its power on every update. Here mode, power and
+/// heat are folded into one signed rate when a unit is opened, and the timer is the simulated
+/// seconds it still has to run, counted down by `advance()` rather than checked against a clock.
+/// The update is then `delta = rate * min(remaining, dt)`, which `advance()` runs `Simd::K_LANES`
+/// units at a time. Rooms are owned by the fleet and independent of `Device::s_room`.
+class AcFleet final {
+public:
+    typedef uint32_t UnitId;
+    typedef uint32_t RoomId;
+    using Mode = RealAC::Mode;
+
+    AcFleet() = default;
+
+    RoomId addRoom(float temp);
+    /// @param power Max power in watts, like `RealAC(power)`.
+    UnitId addUnit(RoomId room, uint32_t power);
+    void reserve(size_t num_units);
+
+    size_t size() const { return m_rate.size(); }
+    size_t roomCount() const { return m_room_temp.size(); }
+    float getRoomTemp(RoomId room) const { return m_room_temp[room]; }
+    void setRoomTemp(RoomId room, float temp) { m_room_temp[room] = temp; }
+    RoomId getRoom(UnitId unit) const { return m_room[unit]; }
+    bool isRunning(UnitId unit) const { return m_remaining_sec[unit] > 0.f; }
+    /// @brief Simulated seconds left in the unit's current session, 0 when idle.
+    float getRemainingSec(UnitId unit) const { return m_remaining_sec[unit]; }
+
+    /// @brief Same as `RealAC::openForMins()`: heat or cool at `mode` for `mins` simulated minutes,
+    /// replacing whatever the unit was doing.
+    void openForMins(UnitId unit, uint32_t mins, bool heat, Mode mode);
+    /// @brief Same as `RealAC::openTillDeg()`: run until the room would reach `target` if this
+    /// unit were alone in it. Heats when the target is above the current room temperature.
+    /// A unit with no power left at `mode` stays idle.
+    void openTillDeg(UnitId unit, float target, Mode mode);
+    void stop(UnitId unit) { m_remaining_sec[unit] = 0.f; }
+
+    /// @brief Advance every unit and room by `seconds` of simulated time in a single pass.
+    void advance(float seconds);
+
+private:
+    // Hot: read and written by every `advance()`.
+    /// @brief Signed degrees per second the unit adds to its room while running.
+    std::vector<float> m_rate;
+    std::vector<float> m_remaining_sec;
+    std::vector<RoomId> m_room;
+    std::vector<float> m_room_temp;
+
+    // Cold: only read when a unit is opened.
+    std::vector<uint32_t> m_power;
+
+    /// @brief Degrees per second of `unit` running at `mode`, before the heat/cool sign.
+    float getRate(UnitId unit, Mode mode) const;
+};
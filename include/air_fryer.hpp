@@ -4,32 +4,141 @@
 #include "utils.hpp"
 
 #include <assert.h>
+#include <queue>
+#include <vector>
 
-/// @brief TODO: Add "AirFryer Concurrency":
+/// @brief Several items can cook at once, each holding its share of the basket:
 /// 0  min: add fish that takes 20 mins;
 /// 5  min: add chicken wings that takes 10 mins;
 /// 15 min: chicken wings ready;
 /// 20 min: fish ready;
+/// `cook()` only reserves volume and returns. Items come out in finish order when time passes,
+/// through `timeTravel()` or `cleanup()`, and give their volume back as they do.
+///
+/// A request that doesn't fit yet is queued, not dropped. Whenever space frees up, the admission
+/// policy packs queued requests into it, and `getStats()` reports how well that goes.
 class AirFryer : public Device {
 public:
+    /// @brief Which queued requests go in when space frees up.
+    enum class Admission : uint32_t {
+        /// @brief In arrival order; a request that doesn't fit blocks the ones behind it.
+        eFifo = 0,
+        /// @brief Biggest first, skipping whatever doesn't fit: fills the basket fuller, so more
+        /// food gets cooked per hour. Equal volumes keep arrival order.
+        eFirstFitDecreasing = 1,
+    };
+
+    /// @brief Since construction or the last `resetStats()`.
+    struct CookStats {
+        uint32_t cooked = 0;
+        /// @brief Requests that had to queue before starting.
+        uint32_t queued = 0;
+        /// @brief Requests still waiting right now.
+        size_t pending = 0;
+        /// @brief Occupied volume integrated over time, over total volume times elapsed time.
+        float utilization = 0.f;
+        /// @brief From `cook()` to the item going in, over every started item.
+        float mean_wait_min = 0.f;
+        float max_wait_min = 0.f;
+    };
+
     /// @brief
     /// @param volume How big is the AirFryer in liter.
     AirFryer(float volume = 5.f) : Device("AirFryer"), k_total_volume(volume), m_volume(volume) {};
     /// @brief
     /// @param data Should store `k_total_volume = m_volume` in `data->dfloat`
-    AirFryer(std::shared_ptr<DeviceData> data)
-        : Device("Air Fryer"), k_total_volume(data->dfloat), m_volume(data->dfloat) {}
-    ~AirFryer() = default;
+    AirFryer(const DeviceData& data)
+        : Device("Air Fryer"), k_total_volume(data.dfloat), m_volume(data.dfloat) {}
+    AirFryer(Identity identity, float volume)
+        : Device(std::move(identity)), k_total_volume(volume), m_volume(volume) {}
+
+    void operate(DeviceData* data) override;
+    void malfunction(DeviceData* data) override;
+    void operateBatch(std::span<DeviceData* const> batch) override { operateEach<AirFryer>(batch); }
+    DeviceKind getKind() const override { return DeviceKind::eAirFryer; }
+    /// @brief Take out every item that finishes within `duration_min`, each in O(log n), and start
+    /// queued requests as space frees up. With 0, cook until basket and queue are empty.
+    uint32_t timeTravel(const uint32_t duration_min) override;
+
+    void saveState(Checkpoint::Writer& out) const override;
+    bool loadState(Checkpoint::Reader& in) override;
 
-    void operate(std::shared_ptr<DeviceData> data) override;
-    void malfunction(std::shared_ptr<DeviceData> data) override;
+    float getTotalVolume() const { return k_total_volume; }
+    void setAdmission(Admission admission) { m_admission = admission; }
+    CookStats getStats() const;
+    void resetStats();
 
 private:
     // Data
     const float k_total_volume;
+    /// @brief Free space, i.e. total volume minus what the cooking items hold.
     float m_volume;
 
+    /// @brief What the basket keeps of a cook command while it cooks.
+    struct Item {
+        SimClock::time_point done;
+        float volume;
+        int minutes;
+        uint32_t cmd_id;
+        DeviceMfId mf_id;
+
+        bool operator>(const Item& other) const { return done > other.done; }
+    };
+    /// @brief Min-heap on finish time: the top is always the next item to come out.
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> m_cooking;
+    /// @brief Finish time of the last item in the basket; the heap only knows the first.
+    SimClock::time_point m_last_done = {};
+
+    /// @brief A cook request waiting for space.
+    struct Request {
+        SimClock::time_point requested;
+        float volume;
+        int minutes;
+        uint32_t cmd_id;
+        DeviceMfId mf_id;
+    };
+    /// @brief In admission order: arrival for `eFifo`, volume descending for FFD.
+    std::vector<Request> m_pending;
+    Admission m_admission = Admission::eFirstFitDecreasing;
+
+    // Stats, see `CookStats`
+    SimClock::time_point m_stats_since = SimClock::now();
+    /// @brief Occupied volume integrated up to `m_stats_until`, in liter minutes.
+    double m_occupied_integral = 0.0;
+    SimClock::time_point m_stats_until = m_stats_since;
+    uint32_t m_cooked = 0;
+    uint32_t m_started = 0;
+    uint32_t m_queued = 0;
+    double m_total_wait_min = 0.0;
+    double m_max_wait_min = 0.0;
+
     // Functions
-    void cook(std::shared_ptr<DeviceData> data);
-    void cleanup(std::shared_ptr<DeviceData> data);
+    void cook(DeviceData* data);
+    /// @brief Waits for the basket to empty, then cleans it. With an engine attached, the commands
+    /// after it in the same batch don't wait: they go in at once, and the cleanup waits for them.
+    void cleanup(DeviceData* data);
+
+    /// @brief Travel until the last item is out, then run `then`. Every queued request fits an
+    /// empty basket, so the queue drains along the way.
+    void cookUntilEmpty(EventEngine::Action then);
+
+    void wake() override { finishUntil(SimClock::now()); }
+
+    /// @brief Take out every item done by `until`, in finish order, give its volume back and
+    /// admit queued requests into it at that moment.
+    void finishUntil(SimClock::time_point until);
+
+    /// @brief Start every queued request the policy lets in at `at`.
+    void admitPending(SimClock::time_point at);
+
+    /// @brief Put `request` in the basket at `at`, and wake up when it is done.
+    void start(const Request& request, SimClock::time_point at);
+
+    /// @brief Integrate occupied volume up to `t` before it changes.
+    void accountUntil(SimClock::time_point t);
+
+    static constexpr Capability::OpTable<AirFryer> K_OP_TABLE = Capability::makeOpTable<AirFryer>({
+        {DeviceOpId::eAirFryerCook, &AirFryer::cook},
+        {DeviceOpId::eAirFryerClean, &AirFryer::cleanup},
+    });
 };
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "device_data.hpp"
+#include "magic_enum/magic_enum.hpp"
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+
+/// @brief The closed set of device types, as far as commands are concerned.
+enum class DeviceKind : uint32_t {
+    eDevice = 0,
+    eDemoDevice = 1,
+    eAirFryer = 2,
+    eWasherDryer = 3,
+    eRealAC = 4,
+
+    COUNT,
+};
+
+/// @brief Which commands each `DeviceKind` accepts, computed at compile time from the enums.
+/// `SmartManager` uses it to reject a command at enqueue time, e.g. a RealAC op sent to an
+/// AirFryer, and devices use `OpTable` to dispatch without a `switch`.
+namespace Capability {
+
+inline constexpr size_t K_OP_COUNT = static_cast<size_t>(DeviceOpId::COUNT);
+inline constexpr size_t K_MF_COUNT = static_cast<size_t>(DeviceMfId::COUNT);
+inline constexpr size_t K_KIND_COUNT = static_cast<size_t>(DeviceKind::COUNT);
+static_assert(K_OP_COUNT <= 64 && K_MF_COUNT <= 64, "capability masks are 64 bits");
+
+/// @brief `DeviceOpId` name prefixes each kind accepts, in `DeviceKind` order. A new op named after
+/// its device (e.g. `eAirFryerBake`) is picked up without touching this table.
+inline constexpr std::array<std::array<std::string_view, 3>, K_KIND_COUNT> K_OP_PREFIXES = {{
+    {"eDefault"},
+    {"eDefault", "eHello", "eSing"},
+    {"eAirFryer"},
+    {"eWashDryer"},
+    {"eRealAc"},
+}};
+
+constexpr uint64_t makeOpMask(DeviceKind kind) {
+    uint64_t mask = 0;
+    for (auto op : magic_enum::enum_values<DeviceOpId>()) {
+        if (op == DeviceOpId::COUNT)
+            continue;
+        for (const auto& prefix : K_OP_PREFIXES[static_cast<size_t>(kind)]) {
+            if (!prefix.empty() && magic_enum::enum_name(op).starts_with(prefix))
+                mask |= uint64_t(1) << static_cast<uint32_t>(op);
+        }
+    }
+    return mask;
+}
+
+/// @brief Bit `op` of `K_OP_MASKS[kind]` is set when `kind` accepts `op`.
+inline constexpr std::array<uint64_t, K_KIND_COUNT> K_OP_MASKS = [] {
+    std::array<uint64_t, K_KIND_COUNT> masks = {};
+    for (auto kind : magic_enum::enum_values<DeviceKind>()) {
+        if (kind != DeviceKind::COUNT)
+            masks[static_cast<size_t>(kind)] = makeOpMask(kind);
+    }
+    return masks;
+}();
+
+/// @brief Every device reacts to every malfunction, so only out-of-range values are rejected.
+inline constexpr uint64_t K_MF_MASK = [] {
+    uint64_t mask = 0;
+    for (auto mf : magic_enum::enum_values<DeviceMfId>()) {
+        if (mf != DeviceMfId::COUNT)
+            mask |= uint64_t(1) << static_cast<uint32_t>(mf);
+    }
+    return mask;
+}();
+
+constexpr bool acceptsOp(DeviceKind kind, DeviceOpId op) {
+    auto bit = static_cast<uint32_t>(op);
+    return bit < K_OP_COUNT && (K_OP_MASKS[static_cast<size_t>(kind)] >> bit & 1);
+}
+
+constexpr bool acceptsMf(DeviceMfId mf) {
+    auto bit = static_cast<uint32_t>(mf);
+    return bit < K_MF_COUNT && (K_MF_MASK >> bit & 1);
+}
+
+constexpr bool accepts(DeviceKind kind, const DeviceData& data) {
+    return acceptsOp(kind, data.op_id) && acceptsMf(data.mf_id);
+}
+
+static_assert(acceptsOp(DeviceKind::eAirFryer, DeviceOpId::eAirFryerCook));
+static_assert(!acceptsOp(DeviceKind::eAirFryer, DeviceOpId::eRealAcOpenForMins));
+static_assert(acceptsOp(DeviceKind::eDemoDevice, DeviceOpId::eSing));
+static_assert(!acceptsOp(DeviceKind::eDevice, DeviceOpId::COUNT));
+
+/// @brief Jump table indexed by `DeviceOpId`: a member function handling that op, or nullptr.
+template <typename T>
+using OpTable = std::array<void (T::*)(DeviceData*), K_OP_COUNT>;
+
+template <typename T>
+constexpr OpTable<T> makeOpTable(
+    std::initializer_list<std::pair<DeviceOpId, void (T::*)(DeviceData*)>> handlers
+) {
+    OpTable<T> table = {};
+    for (auto [op, handler] : handlers) {
+        table[static_cast<size_t>(op)] = handler;
+    }
+    return table;
+}
+
+/// @brief A table may only handle ops its kind accepts; checked with static_assert per device.
+template <typename T>
+constexpr bool handlesOnlyAccepted(const OpTable<T>& table, DeviceKind kind) {
+    for (size_t op = 0; op < K_OP_COUNT; op++) {
+        if (table[op] != nullptr && !acceptsOp(kind, static_cast<DeviceOpId>(op)))
+            return false;
+    }
+    return true;
+}
+
+} // namespace Capability
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "device.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/// @brief Versioned binary snapshot of a `SmartManager`, see `SmartManager::saveCheckpoint()`.
+///
+/// Layout: header ("SHCKPT", version), the room, then per device its kind, constructor
+/// arguments, `Device::saveState()` and the manager's pending commands for it.
+/// Fields are raw native-endian values, so a checkpoint is meant for the machine that wrote it.
+///
+/// Time points are stored relative to `SimClock::now()` when saving, with no absolute time in the
+/// file, and re-based onto `SimClock::now()` when restoring: a timer 3 minutes from done is 3
+/// minutes from done after a restart, however long the process was down.
+namespace Checkpoint {
+
+inline constexpr char K_MAGIC[8] = {'S', 'H', 'C', 'K', 'P', 'T', '\0', '\0'};
+/// @brief Bump whenever any `saveState()` layout changes; older files are then rejected.
+inline constexpr uint32_t K_VERSION = 1;
+
+/// @brief Appends fields to an in-memory buffer, written to disk in one go by `commit()`.
+class Writer final {
+public:
+    Writer() : m_now(SimClock::now()) {}
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void put(const T& value) {
+        auto offset = m_bytes.size();
+        m_bytes.resize(offset + sizeof(T));
+        std::memcpy(m_bytes.data() + offset, &value, sizeof(T));
+    }
+    void putString(std::string_view str);
+    /// @brief Stored as an offset from the time the writer was created.
+    void putTime(SimClock::time_point t) { put((t - m_now).count()); }
+    void putTimer(const Timer<>& timer);
+    /// @brief Every field of a command but `success`, which is an output.
+    void putData(const DeviceData& data);
+
+    std::span<const char> getBytes() const { return m_bytes; }
+    /// @brief What `putTime()` offsets are relative to.
+    SimClock::time_point getTimeBase() const { return m_now; }
+    /// @brief Start over, keeping the capacity; later `putTime()` calls use the same base.
+    void clear() { m_bytes.clear(); }
+
+    /// @brief Write the buffer to `path` atomically: to a temporary file next to it first, flushed
+    /// to disk and then renamed over `path`, so a crash leaves either the old or the new file. The
+    /// directory is flushed after the rename, so the new file survives a crash once this returns.
+    /// @return success
+    bool commit(const std::string& path) const;
+
+private:
+    std::vector<char> m_bytes;
+    const SimClock::time_point m_now;
+};
+
+/// @brief Reads fields back from a mapped checkpoint. Once a read fails, e.g. past the end of a
+/// truncated file, every later read fails too, so callers can check `ok()` once at the end.
+class Reader final {
+public:
+    explicit Reader(std::string_view bytes) : m_rest(bytes), m_now(SimClock::now()) {}
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    bool get(T& value) {
+        if (!m_ok || m_rest.size() < sizeof(T))
+            return m_ok = false;
+        std::memcpy(&value, m_rest.data(), sizeof(T));
+        m_rest.remove_prefix(sizeof(T));
+        return true;
+    }
+    /// @brief Also fails on a value outside the enum, e.g. `COUNT`.
+    template <typename E>
+        requires std::is_enum_v<E>
+    bool getEnum(E& value) {
+        std::underlying_type_t<E> raw;
+        if (!get(raw) || !magic_enum::enum_contains<E>(raw))
+            return m_ok = false;
+        value = static_cast<E>(raw);
+        if constexpr (requires { E::COUNT; }) {
+            if (value == E::COUNT)
+                return m_ok = false;
+        }
+        return true;
+    }
+    bool getString(std::string& str);
+    /// @brief The stored offset, applied to the time the reader was created.
+    bool getTime(SimClock::time_point& t);
+    bool getTimer(Timer<>& timer);
+    bool getData(DeviceData& data);
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_rest.empty(); }
+    /// @brief What hasn't been read yet.
+    std::string_view getRest() const { return m_rest; }
+
+private:
+    std::string_view m_rest;
+    const SimClock::time_point m_now;
+    bool m_ok = true;
+};
+
+/// @brief Kind, constructor arguments and `Device::saveState()` of `device`.
+void writeDevice(Writer& out, const Device& device);
+
+/// @brief Rebuild a device written by `writeDevice()`.
+/// @return nullptr on an unknown kind or a malformed record.
+std::shared_ptr<Device> readDevice(Reader& in);
+
+} // namespace Checkpoint
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "checkpoint.hpp"
+
+#include <cstdio>
+#include <optional>
+#include <string>
+
+/// @brief Record of everything fed to a `SmartManager`, for replaying an incident exactly, see
+/// `SmartManager::startRecording()` and `SmartManager::replay()`.
+///
+/// Layout: header ("SHCMDLOG", version, start time), then events. Each event is its `Event` tag
+/// and simulated time, then its payload, encoded like a `Checkpoint`. Times are offsets from the
+/// start time, which the replay puts the virtual clock back to.
+namespace CommandLog {
+
+inline constexpr char K_MAGIC[8] = {'S', 'H', 'C', 'M', 'D', 'L', 'O', 'G'};
+/// @brief Bump with `Checkpoint::K_VERSION` too, since device records are embedded.
+inline constexpr uint32_t K_VERSION = 1;
+
+enum class Event : uint8_t {
+    /// @brief The manager as recording starts, in checkpoint layout. Always the first event.
+    eState = 0,
+    /// @brief `addDevice()`: the device as `Checkpoint::writeDevice()` writes it.
+    eAddDevice = 1,
+    /// @brief A command the manager took: device id, then whether it is a command at all and the
+    /// command, `cmd_id` included.
+    eCommand = 2,
+    /// @brief `addTravleTime()`: device id and minutes.
+    eTravelTime = 3,
+    /// @brief `operate()`.
+    eOperate = 4,
+
+    COUNT,
+};
+
+/// @brief Streams events to a file as they happen. Every event goes through one reused buffer.
+class Recorder final {
+public:
+    ~Recorder() { close(); }
+
+    /// @brief Create `path` and write the header; the start time is now.
+    /// @return success
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+
+    /// @brief Start an event stamped with the current simulated time. Append its payload to the
+    /// returned writer, then call `end()`.
+    Checkpoint::Writer& begin(Event event);
+    /// @brief Write the event out. An `eOperate` is also flushed, so a crash loses at most the
+    /// round in progress.
+    void end();
+
+private:
+    std::FILE* m_file = nullptr;
+    /// @brief Its time base is the start time.
+    std::optional<Checkpoint::Writer> m_event;
+    Event m_last = Event::eState;
+};
+
+} // namespace CommandLog
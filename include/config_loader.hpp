@@ -0,0 +1,44 @@
+#pragma once
+
+#include "smart_manager.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// @brief Devices and commands from a text file instead of hard-coded `populate*()` calls.
+///
+/// One statement per line, fields separated by spaces; `#` starts a comment. Commands and travel
+/// time belong to the device above them:
+///
+///     device eAirFryer 3.0          # kind, then its constructor argument
+///     travel 0                      # Device::timeTravel() minutes
+///     cmd eAirFryerCook eNormal 2.0 5 0
+///     nop                           # a session with no command
+///
+/// Device arguments by kind: `eDevice` and `eDemoDevice` a name, `eAirFryer` a volume,
+/// `eWasherDryer` a volume and optional bin capacity, `eRealAC` a power in watts. A command is
+/// `cmd <op> [mf] [dfloat] [dint] [dbool] [dstring...]`; missing trailing fields are zero or empty.
+///
+/// The file is memory-mapped and parsed in one pass with `std::from_chars` and sorted enum name
+/// tables, then each device's commands go to `SmartManager::addMultipleData()` in one call.
+/// A malformed line, or a command the device doesn't support, is logged with its line number and
+/// skipped.
+namespace Config {
+
+struct LoadStats {
+    size_t devices = 0;
+    size_t commands = 0;
+    /// @brief Lines skipped, plus devices the manager rejected.
+    size_t errors = 0;
+};
+
+/// @brief Parse config `text` into `manager`.
+LoadStats load(std::string_view text, SmartManager& manager);
+
+/// @brief Map the file at `path` and parse it into `manager`.
+/// @return std::nullopt if the file can't be opened.
+std::optional<LoadStats> loadFile(const std::string& path, SmartManager& manager);
+
+} // namespace Config
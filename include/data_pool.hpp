@@ -0,0 +1,103 @@
+#pragma once
+
+#include "device_data.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/// @brief Slab allocator backing every `DeviceData` that `SmartManager` creates.
+/// Memory comes in slabs of `K_BLOCKS_PER_SLAB` fixed-size blocks; `DataPool::make()` places the
+/// `shared_ptr` control block and the `DeviceData` together in one block, so a command costs no
+/// heap allocation once the first slab exists, and consecutive commands sit next to each other.
+///
+/// Allocation bumps through the slabs, freed blocks go to an intrusive free list; both O(1).
+/// `reset()` frees everything at once by rewinding the bump cursor, which `SmartManager` does
+/// after each `operate()`. Slabs are kept and reused by the next round.
+///
+/// Blocks may be released from any thread, e.g. a `WasherDryer` popping its bin on a worker, but
+/// the pool must outlive every `DeviceData` made from it; `SmartManager` declares its pool before
+/// the devices that may keep data in their bins.
+class DataPool final {
+public:
+    /// @brief Fits a `DeviceData` plus libstdc++/libc++ `allocate_shared` bookkeeping.
+    static constexpr size_t K_BLOCK_SIZE = 128;
+    static constexpr size_t K_BLOCKS_PER_SLAB = 256;
+
+    /// @brief Standard allocator handing out `DataPool` blocks, meant for `std::allocate_shared`.
+    /// Requests that don't fit a block fall back to the global heap.
+    template <typename T>
+    class Allocator {
+    public:
+        using value_type = T;
+
+        explicit Allocator(DataPool* pool) : m_pool(pool) {}
+        template <typename U>
+        Allocator(const Allocator<U>& other) : m_pool(other.m_pool) {}
+
+        T* allocate(size_t n) {
+            if (fitsBlock(n))
+                return static_cast<T*>(m_pool->allocate());
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        void deallocate(T* p, size_t n) {
+            if (fitsBlock(n))
+                m_pool->deallocate(p);
+            else
+                ::operator delete(p);
+        }
+
+        template <typename U>
+        bool operator==(const Allocator<U>& other) const {
+            return m_pool == other.m_pool;
+        }
+
+    private:
+        template <typename U>
+        friend class Allocator;
+
+        DataPool* m_pool;
+
+        static constexpr bool fitsBlock(size_t n) {
+            return alignof(T) <= alignof(std::max_align_t) && n * sizeof(T) <= K_BLOCK_SIZE;
+        }
+    };
+
+    DataPool() = default;
+    DataPool(const DataPool&) = delete;
+    DataPool& operator=(const DataPool&) = delete;
+
+    /// @brief Create a default `DeviceData`: a single block and no heap allocation.
+    std::shared_ptr<DeviceData> make() {
+        return std::allocate_shared<DeviceData>(Allocator<DeviceData>(this));
+    }
+
+    /// @brief One block of `K_BLOCK_SIZE` bytes, aligned for any scalar type.
+    void* allocate();
+    void deallocate(void* p);
+
+    /// @brief Free every block at once, only if none is still in use.
+    /// @return Whether the pool was rewound.
+    bool reset();
+
+    /// @brief Blocks currently handed out.
+    size_t getLiveCount() const;
+    size_t getSlabCount() const;
+
+private:
+    union Block {
+        Block* next;
+        alignas(std::max_align_t) std::byte bytes[K_BLOCK_SIZE];
+    };
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Block[]>> m_slabs;
+    /// @brief Next never-used block is `m_slabs[m_slab][m_bump]`.
+    size_t m_slab = 0;
+    size_t m_bump = 0;
+    /// @brief Singly linked through `Block::next`.
+    Block* m_free = nullptr;
+    size_t m_live = 0;
+};
@@ -1,24 +1,49 @@
 #pragma once
 
+#include "capability.hpp"
 #include "device_data.hpp"
+#include "event_engine.hpp"
+#include "logger.hpp"
+#include "op_log.hpp"
 #include "room.hpp"
+#include "sim_clock.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <format>
-#include <iostream>
 #include <memory>
 #include <string>
-#include <thread>
+#include <vector>
+
+namespace Checkpoint {
+class Writer;
+class Reader;
+} // namespace Checkpoint
 
 /// @brief Timer a reusable time check that does NOT simulate time elapsing.
+/// The clock is a compile-time policy: the default `SimClock` follows virtual time when the
+/// manager runs simulated, while `ManualClock`, `ScaledClock` or `std::chrono::steady_clock`
+/// can be swapped in without any virtual call.
+template <ClockPolicy Clock = SimClock>
 struct Timer {
+    using clock = Clock;
+
     Timer() = default;
-    void begin(uint32_t total_time_sec) {
-        t_total_sec = std::chrono::seconds(total_time_sec);
-        t_start = std::chrono::system_clock::now();
+    /// @param total_time Simulated duration, e.g. `std::chrono::minutes(5)`.
+    void begin(std::chrono::seconds total_time) { beginAt(Clock::now(), total_time); }
+    /// @brief Like `begin()`, for a session that started at `start` rather than now, e.g. a job
+    /// queued behind another one that finished while nobody was watching.
+    void beginAt(typename Clock::time_point start, std::chrono::seconds total_time) {
+        t_total_sec = total_time;
+        t_start = start;
         running = true;
     }
 
+    /// @brief Whole seconds since `begin()`, read from the clock exactly once.
+    std::chrono::seconds elapsed() const {
+        return std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - t_start);
+    }
+
     /// @brief Check if the timer is still running.
     /// If time is up (now - start >= target), `Stop()` and return 0;
     /// Else, return remaining time.
@@ -27,23 +52,23 @@ struct Timer {
     /// Note that `running` bool check should be done outside.
     /// @return remaining_time Output, unit is sec.
     int checkRemainingTime() {
-        using namespace std::chrono;
         if (!running) {
             // just a safe guard.
             return 0;
-        } else if (duration_cast<seconds>(system_clock::now() - t_start) >= t_total_sec) {
+        }
+        auto time_spent = elapsed();
+        if (time_spent >= t_total_sec) {
             stop();
             return 0;
-        } else {
-            // can use .count() directly since we use consistent unit second.
-            return (t_total_sec - duration_cast<seconds>(system_clock::now() - t_start)).count();
         }
+        // can use .count() directly since we use consistent unit second.
+        return (t_total_sec - time_spent).count();
     }
 
     /// @brief set to not running state
     void stop() { running = false; }
 
-    std::chrono::system_clock::time_point t_start;
+    typename Clock::time_point t_start;
     std::chrono::seconds t_total_sec;
     bool running = false;
 };
@@ -55,65 +80,142 @@ class Device {
 public:
     /// @brief Constructor
     /// @param name device name, should be unique.
-    Device(std::string name) : m_name(name + "_" + std::to_string(s_global_id)), m_on(true) {
+    Device(std::string name)
+        : m_name(name + "_" + std::to_string(s_global_id)), m_on(true), m_id(s_global_id),
+          m_name_id(OpStringTable::global().intern(m_name)) {
         s_total_count++;
         s_global_id++;
     }
 
+    /// @brief Name and id of a device being restored, see `Checkpoint::readDevice()`.
+    struct Identity {
+        std::string name;
+        uint32_t id;
+    };
+    /// @brief Constructor for a restore: takes the saved name and id as they are, so the only
+    /// string interned is the real name and a restored run interns what the original did.
+    explicit Device(Identity identity)
+        : m_name(std::move(identity.name)), m_on(true), m_id(identity.id),
+          m_name_id(OpStringTable::global().intern(m_name)) {
+        s_total_count++;
+        s_global_id = std::max(s_global_id, m_id + 1);
+    }
+
+    /// @brief Copies and moves keep the id and count as another live device, so containers
+    /// holding devices by value (`DeviceFleet`) keep `s_total_count` right when they relocate.
+    Device(const Device& other)
+        : m_name(other.m_name), m_on(other.m_on), m_id(other.m_id), m_name_id(other.m_name_id),
+          m_records(other.m_records) {
+        s_total_count++;
+    }
+    Device(Device&& other) noexcept
+        : m_name(std::move(other.m_name)), m_on(other.m_on), m_id(other.m_id),
+          m_name_id(other.m_name_id), m_records(std::move(other.m_records)) {
+        s_total_count++;
+    }
+
     /// @brief
     /// @return device name
-    std::string getName() const { return m_name; }
+    const std::string& getName() const { return m_name; }
+    /// @brief Unique and stable, unlike the name which can be hacked. Only a checkpoint restore
+    /// sets it, to the id the device had when saved.
+    uint32_t getId() const { return m_id; }
+    /// @brief Current name in `OpStringTable::global()`.
+    uint32_t getNameId() const { return m_name_id; }
 
+    template <ClockPolicy Clock = SimClock>
     std::string getCurrentTime() const {
-        return std::format("{:%T}", std::chrono::system_clock::now());
+        return formatClockTime<Clock>(Clock::now());
     }
 
-    /// @brief Log what has been done in an `operate()` which is stored in `data->dstring`.
+    /// @brief Log what has been done in an `operate()`, rendering the `OpRecord`s emitted for
+    /// `data` to text. This is the only place text is formatted.
     /// @param data
-    void logOperation(const std::shared_ptr<DeviceData> data = nullptr) const {
-        if (data == nullptr) {
-            std::cout << std::format("Empty log: I have done nothing!\n");
-        } else {
-            std::cout << std::format(
-                "{} log: {}\n", magic_enum::enum_name(data->op_id), data->dstring
-            );
-        }
-    }
+    void logOperation(const DeviceData* data = nullptr) const;
+
+    /// @brief Binary counterpart of `logOperation()`: append the framing record that closes
+    /// `data` (or an empty-log record) instead of formatting anything.
+    void recordOperation(const DeviceData* data = nullptr);
+
+    /// @brief Binary counterpart of the "=====name at time=====" banner.
+    void recordSession();
+
+    /// @brief Records emitted since the last `clearRecords()`, in emission order.
+    std::span<const OpRecord> getRecords() const { return m_records; }
+    /// @brief Keeps capacity, so steady-state emission doesn't allocate.
+    void clearRecords() { m_records.clear(); }
+
+    /// @brief Which commands this device accepts, see `Capability`.
+    virtual DeviceKind getKind() const { return DeviceKind::eDevice; }
 
     /// @brief Should better be called before creating any Device instance.
     static void loginRoom(std::shared_ptr<Room> room) { s_room = room; }
+    /// @brief nullptr until `loginRoom()`.
+    static Room* getRoom() { return s_room.get(); }
+
+    /// @brief Run every device's timers as events on `engine` from now on, nullptr to settle them
+    /// inline in `timeTravel()` again. `SmartManager` attaches its own while it operates on the
+    /// virtual clock; only ever attach one from the thread that runs it.
+    static void attachEngine(EventEngine* engine) { s_engine = engine; }
+
+    /// @brief Run `then` once the last `timeTravel()`, and any wait inside a command, is over:
+    /// right away without an engine, otherwise as an event at its end.
+    void afterTravel(EventEngine::Action then);
+
+    /// @brief Append what `Checkpoint::readDevice()` needs beyond the constructor arguments to
+    /// bring this device back: name, id and on/off here, plus whatever a subclass keeps.
+    /// Subclasses call the base version first.
+    virtual void saveState(Checkpoint::Writer& out) const;
+    /// @brief Counterpart of `saveState()` on a freshly constructed device of the same kind.
+    /// The device takes over the saved id, and later devices are numbered after it.
+    /// @return success
+    virtual bool loadState(Checkpoint::Reader& in);
 
     // BEGIN virtual functions
 
     /// @brief Simulate how the device behave when function properly
     /// @param op_id Identify which operations to be performed, because there can be many.
-    virtual void operate(std::shared_ptr<DeviceData> data = nullptr) {
+    virtual void operate(DeviceData* data = nullptr) {
         if (data == nullptr || data->op_id == DeviceOpId::eDefault) {
-            std::cout << "I am a " << this->getName() << " and I do NOTHING!" << std::endl;
+            Log::info("I am a {} and I do NOTHING!", getName());
         }
     }
 
     /// @brief Simulate time elapsing and update Device accordingly.
     /// It supports partial update for Device with relevant data.
-    /// @example For `RealAC` that will open for 10s and go 25->20 degree, simulte for 6s will
+    /// @example For `RealAC` that will open for 10 mins and go 25->20 degree, simulte for 6 mins will
     /// result in temperature updated to 22 degree.
     /// @example For `WasherDryer` that doesn't have "gradual" data like temperature, update is
     /// all or nothing except for the `Timer`.
-    /// @param duration_sec If set to 0, the device should simulate till the finish of current
-    /// opeation. Otherwise it simulate for exactly `duration_sec` seconds.
-    /// @return How long we have simulated, equal to `duration_sec` if it != 0.
-    virtual uint32_t timeTravel(const uint32_t duration_sec = 0) {
-        std::this_thread::sleep_for(std::chrono::seconds(duration_sec));
-        return duration_sec;
+    /// @param duration_min If set to 0, the device should simulate till the finish of current
+    /// opeation. Otherwise it simulate for exactly `duration_min` simulated minutes; how much real
+    /// time that takes depends on `SimClock`'s `TimeScale`.
+    /// With an engine attached, this only schedules the travel and returns; see `afterTravel()`.
+    /// @return How long we have simulated in minutes, equal to `duration_min` if it != 0. With an
+    /// engine, nothing has been simulated yet when it returns, so an open-ended travel returns 0.
+    virtual uint32_t timeTravel(const uint32_t duration_min = 0) {
+        travelFor(std::chrono::minutes(duration_min), [] {});
+        return duration_min;
     }
 
     /// @brief Simulate how the device behave when function incorrectly
     /// @param mf_id Identify which operations to be performed, because there can be many.
-    virtual void malfunction(std::shared_ptr<DeviceData> data = nullptr) {
+    virtual void malfunction(DeviceData* data = nullptr) {
         if (data == nullptr || data->mf_id == DeviceMfId::eNormal) {
-            std::cerr << std::format("Philosophical question from {}: ", getName())
-                      << "If I run normally while malfunction, do I run correctly or incorrectly?"
-                      << std::endl;
+            Log::warn(
+                "Philosophical question from {}: If I run normally while malfunction, do I run "
+                "correctly or incorrectly?",
+                getName()
+            );
+        }
+    }
+
+    /// @brief `operate()` then `malfunction()` every command of `batch`, in order, in one call.
+    /// Devices override it to drop per-command virtual dispatch or to merge commands.
+    virtual void operateBatch(std::span<DeviceData* const> batch) {
+        for (auto* data : batch) {
+            operate(data);
+            malfunction(data);
         }
     }
 
@@ -122,6 +224,9 @@ public:
 protected:
     std::string m_name = "NULL";
     bool m_on = false;
+    uint32_t m_id = 0;
+    uint32_t m_name_id = 0;
+    std::vector<OpRecord> m_records;
     // increment only
     inline static uint32_t s_global_id = 0;
     // increment & decrement
@@ -129,6 +234,22 @@ protected:
     /// @brief static because the room should be unique, while it's shared
     /// across all devices.
     inline static std::shared_ptr<Room> s_room = nullptr;
+    /// @brief See `attachEngine()`.
+    inline static EventEngine* s_engine = nullptr;
+
+    /// @brief Let `d` of simulated time pass for this device, then run `then`. Without an engine it
+    /// sleeps and runs `then` inline; with one it schedules `then` at the end and returns, and
+    /// `afterTravel()` waits for it. `then` may travel further.
+    void travelFor(SimClock::duration d, EventEngine::Action then);
+
+    /// @brief Something this device started, a job, an item or an AC session, finishes at `at`:
+    /// have the engine call `wake()` then. Without an engine it's a no-op, and `timeTravel()`
+    /// settles it instead.
+    void wakeAt(SimClock::time_point at);
+
+    /// @brief Settle whatever is due by `SimClock::now()`. Called at the times passed to
+    /// `wakeAt()`, maybe after a travel settled it already, so it must be idempotent.
+    virtual void wake() {}
 
     /// @brief A universal malfunction corresponding to DeviceMfId::eHacked,
     /// replace the first `len` char of `m_name` with `newName`.
@@ -136,6 +257,52 @@ protected:
     /// @param newName
     /// @param len
     void hackName(std::string newName, size_t len);
+
+    /// @brief `operateBatch()` for a concrete `T`: non-virtual calls, and nothing after the device
+    /// switches off, since a device that is off ignores every command anyway.
+    template <typename T>
+    void operateEach(std::span<DeviceData* const> batch) {
+        auto* self = static_cast<T*>(this);
+        for (auto* data : batch) {
+            if (!m_on)
+                break;
+            self->T::operate(data);
+            self->T::malfunction(data);
+        }
+    }
+
+    /// @brief Jump to the handler `table` has for `data->op_id`. Ops without a handler fall back to
+    /// `Device::operate()`, and are reported unless this kind accepts them (e.g. `eDefault`).
+    template <typename T>
+    void dispatch(const Capability::OpTable<T>& table, DeviceData* data) {
+        auto op = static_cast<size_t>(data->op_id);
+        if (auto handler = op < table.size() ? table[op] : nullptr) {
+            (static_cast<T*>(this)->*handler)(data);
+            return;
+        }
+        Device::operate();
+        if (!Capability::acceptsOp(getKind(), data->op_id))
+            data->logOpId();
+    }
+
+    /// @brief Record what happened for `data` as a fixed-size `OpRecord` instead of formatting
+    /// text. Fill the event-specific payload through the returned reference.
+    /// @param time When it happened, defaults to now.
+    OpRecord& emit(const DeviceData& data, OpEvent event, SimClock::time_point time = SimClock::now());
+    /// @brief Same, for a command whose `DeviceData` the device no longer has.
+    OpRecord& emit(
+        uint32_t cmd_id,
+        DeviceOpId op_id,
+        DeviceMfId mf_id,
+        OpEvent event,
+        SimClock::time_point time = SimClock::now()
+    );
+
+private:
+    /// @brief `travelFor()` events still pending on the engine.
+    uint32_t m_travels = 0;
+    /// @brief Set by `afterTravel()` while travels are pending.
+    EventEngine::Action m_after_travel;
 };
 
 /// @brief A "better" placeholder class to demo
@@ -143,22 +310,34 @@ protected:
 class DemoDevice : public Device {
 public:
     DemoDevice(std::string name) : Device(name) {};
+    explicit DemoDevice(Identity identity) : Device(std::move(identity)) {}
     /// @brief Operate() overridden by DemoDevice
     /// @param op_id Identify which operations to be performed, because there can be many.
-    void operate(std::shared_ptr<DeviceData> data) override;
+    void operate(DeviceData* data) override;
 
-    void malfunction(std::shared_ptr<DeviceData> data) override;
+    void malfunction(DeviceData* data) override;
+    void operateBatch(std::span<DeviceData* const> batch) override {
+        operateEach<DemoDevice>(batch);
+    }
+    DeviceKind getKind() const override { return DeviceKind::eDemoDevice; }
 
 private:
     // All normal operations
-    std::string hello() const;
-    std::string sing() const;
+    void hello(DeviceData* data);
+    void sing(DeviceData* data);
+
+    static constexpr Capability::OpTable<DemoDevice> K_OP_TABLE =
+        Capability::makeOpTable<DemoDevice>({
+            {DeviceOpId::eHello, &DemoDevice::hello},
+            {DeviceOpId::eSing, &DemoDevice::sing},
+        });
 
     // All malfunctions
 
     // Special data
 };
 
+/// @brief Owning list; pass `.get()` to `Device::operate()` and friends.
 typedef std::vector<std::shared_ptr<DeviceData>> DataList;
-typedef std::unordered_map<std::string, std::shared_ptr<Device>> DeviceMap;
-typedef std::unordered_map<std::string, DataList> DataMap;
+/// @brief Dense index of a `Device` inside its `SmartManager`, assigned by `addDevice()`.
+typedef uint32_t DeviceId;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "logger.hpp"
 #include "magic_enum/magic_enum.hpp"
-#include <iostream>
+
+#include <memory>
 #include <string>
 
 enum class DeviceOpId : uint32_t {
@@ -33,6 +35,8 @@ enum class DeviceMfId : uint32_t {
 };
 
 /// @brief Data struct to unify input & output of ALL devices.
+/// `SmartManager` owns every instance; devices only borrow a `DeviceData*` for the duration of a
+/// call. A device that must remember a command (`WasherDryer`'s bins) copies what it needs.
 struct DeviceData {
     float dfloat;
     int dint;
@@ -42,13 +46,13 @@ struct DeviceData {
     bool success = false;
     DeviceOpId op_id;
     DeviceMfId mf_id;
+    /// @brief Unique per `SmartManager`, assigned on submission. Ties `OpRecord`s to their command.
+    uint32_t cmd_id = 0;
 
     inline void logOpId() const {
-        std::cout << "Because of unrecognized DeviceOpId::" << magic_enum::enum_name(op_id)
-                  << std::endl;
+        Log::info("Because of unrecognized DeviceOpId::{}", magic_enum::enum_name(op_id));
     }
     inline void logMfId() const {
-        std::cout << "Because of unrecognized DeviceMfId::" << magic_enum::enum_name(mf_id)
-                  << std::endl;
+        Log::info("Because of unrecognized DeviceMfId::{}", magic_enum::enum_name(mf_id));
     }
 };
\ No newline at end of file
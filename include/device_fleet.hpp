@@ -0,0 +1,75 @@
+#pragma once
+
+#include "air_fryer.hpp"
+#include "device.hpp"
+#include "real_ac.hpp"
+#include "washer_dryer.hpp"
+
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/// @brief Opt-in, statically dispatched alternative to a list of `std::shared_ptr<Device>`.
+/// Device types are a closed set, so each device is stored by value as one alternative of a
+/// `std::variant`, contiguous in a single vector. A command visits the variant once and then calls
+/// the concrete type's `operate()` / `malfunction()` with a qualified, non-virtual call the
+/// compiler can inline, instead of two virtual calls through a pointer to a separate allocation.
+///
+/// Adding a device type means adding it to `AnyDevice`; anything else keeps using `Device`'s
+/// virtual interface, which every alternative still implements.
+class DeviceFleet final {
+public:
+    using AnyDevice = std::variant<Device, DemoDevice, AirFryer, WasherDryer, RealAC>;
+
+    /// @brief Construct a `T` in place at the end of the fleet.
+    /// @return Its index, used by every other call.
+    template <typename T, typename... Args>
+    DeviceId emplace(Args&&... args) {
+        auto id = static_cast<DeviceId>(m_devices.size());
+        m_devices.emplace_back(std::in_place_type<T>, std::forward<Args>(args)...);
+        return id;
+    }
+
+    void reserve(size_t count) { m_devices.reserve(count); }
+    size_t size() const { return m_devices.size(); }
+
+    /// @brief Run `fn` on the concrete device, e.g. `fleet.visit(id, [](auto& d) { ... })`.
+    template <typename F>
+    decltype(auto) visit(DeviceId id, F&& fn) {
+        return std::visit(std::forward<F>(fn), m_devices[id]);
+    }
+
+    /// @brief Type-erased access through the usual virtual interface.
+    Device& operator[](DeviceId id) {
+        return visit(id, [](auto& device) -> Device& { return device; });
+    }
+
+    /// @brief Same as `Device::operate()` followed by `Device::malfunction()`, statically
+    /// dispatched.
+    void operate(DeviceId id, DeviceData* data) {
+        visit(id, [data](auto& device) {
+            using T = std::remove_cvref_t<decltype(device)>;
+            device.T::operate(data);
+            device.T::malfunction(data);
+        });
+    }
+
+    void operateBatch(DeviceId id, std::span<DeviceData* const> batch) {
+        visit(id, [batch](auto& device) {
+            using T = std::remove_cvref_t<decltype(device)>;
+            device.T::operateBatch(batch);
+        });
+    }
+
+    uint32_t timeTravel(DeviceId id, uint32_t duration_min) {
+        return visit(id, [duration_min](auto& device) {
+            using T = std::remove_cvref_t<decltype(device)>;
+            return device.T::timeTravel(duration_min);
+        });
+    }
+
+private:
+    std::vector<AnyDevice> m_devices;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "sim_clock.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+/// @brief Discrete-event engine driving `SimClock`.
+/// Pending events sit in a min-heap keyed by (time, submission order), so events scheduled for the
+/// same time point run in FIFO order. `run()` pops them one by one and jumps the virtual clock to
+/// each event's time instead of sleeping until it.
+///
+/// Devices put their own future on it (see `Device::attachEngine()`): a job, cook or AC session
+/// schedules its completion at the time it finishes, and a `timeTravel()` schedules its end, so
+/// devices of one `SmartManager::operate()` round interleave in simulated time.
+///
+/// Events are never run nested: a `SimClock::sleepFor()` issued inside an event only moves the
+/// clock, and the next event is dispatched after the current one returns.
+class EventEngine final {
+public:
+    using Action = std::function<void()>;
+
+    /// @brief Schedule `action` to run at simulated time `at`.
+    void schedule(SimClock::time_point at, Action action);
+
+    /// @brief Schedule `action` to run `delay` after the current simulated time.
+    void scheduleAfter(SimClock::duration delay, Action action) {
+        schedule(SimClock::now() + delay, std::move(action));
+    }
+
+    /// @brief Dispatch pending events, including those scheduled while running, until none is left
+    /// or an event calls `stop()`.
+    /// @return Number of events dispatched.
+    size_t run();
+
+    /// @brief Make `run()` return once the current event is done. Events still queued stay for the
+    /// next `run()`, e.g. a job finishing after the round that started it.
+    void stop() { m_stopped = true; }
+
+    size_t pending() const { return m_queue.size(); }
+
+private:
+    struct Event {
+        SimClock::time_point at;
+        uint64_t seq;
+        Action action;
+    };
+    /// @brief std::priority_queue is a max-heap; invert to get the earliest event on top.
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const {
+            return a.at != b.at ? a.at > b.at : a.seq > b.seq;
+        }
+    };
+
+    std::priority_queue<Event, std::vector<Event>, Later> m_queue;
+    uint64_t m_next_seq = 0;
+    bool m_stopped = false;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <string>
+
+/// @brief Severity of a log line. `eDebug` and `eInfo` go to stdout, the rest to stderr.
+enum class LogLevel : uint32_t {
+    eDebug = 0,
+    eInfo = 1,
+    eWarn = 2,
+    eError = 3,
+};
+
+/// @brief Lines below this level are compiled out: no formatting, no enqueue.
+/// Override with e.g. `-DSMARTHOME_MIN_LOG_LEVEL=2` to keep only warnings and errors.
+#ifndef SMARTHOME_MIN_LOG_LEVEL
+#define SMARTHOME_MIN_LOG_LEVEL 1
+#endif
+
+/// @brief Asynchronous, buffered logging.
+/// Each thread appends finished lines to its own lock-free single-producer ring; a background
+/// flusher drains all rings and writes them in large chunks, so the simulation loop never waits on
+/// a flush syscall. Lines from one thread keep their order; lines from different threads are only
+/// ordered per flush round.
+///
+/// Pending lines are flushed at exit, on `std::terminate` and on fatal signals (SIGSEGV, SIGABRT,
+/// ...), so a failed `Debug::logAssert` still shows everything logged before it.
+namespace Log {
+
+/// @brief Enqueue one line (a newline is appended). Thread-safe; only blocks when this thread's
+/// ring is full and the flusher has to catch up.
+void write(LogLevel level, std::string line);
+
+/// @brief Block until every line enqueued so far has been written out.
+void flush();
+
+/// @brief Redirect output, e.g. to a file for replay comparison. Flushes first.
+/// @param out Destination of `eDebug` and `eInfo` lines.
+/// @param err Destination of `eWarn` and `eError` lines.
+void setOutput(std::FILE* out, std::FILE* err);
+
+template <LogLevel Level, typename... Args>
+inline void log(std::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (static_cast<uint32_t>(Level) >= SMARTHOME_MIN_LOG_LEVEL) {
+        write(Level, std::format(fmt, std::forward<Args>(args)...));
+    }
+}
+
+template <typename... Args>
+inline void debug(std::format_string<Args...> fmt, Args&&... args) {
+    log<LogLevel::eDebug>(fmt, std::forward<Args>(args)...);
+}
+template <typename... Args>
+inline void info(std::format_string<Args...> fmt, Args&&... args) {
+    log<LogLevel::eInfo>(fmt, std::forward<Args>(args)...);
+}
+template <typename... Args>
+inline void warn(std::format_string<Args...> fmt, Args&&... args) {
+    log<LogLevel::eWarn>(fmt, std::forward<Args>(args)...);
+}
+template <typename... Args>
+inline void error(std::format_string<Args...> fmt, Args&&... args) {
+    log<LogLevel::eError>(fmt, std::forward<Args>(args)...);
+}
+
+} // namespace Log
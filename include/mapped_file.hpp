@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/// @brief Read-only view of a whole file: memory-mapped where possible, read into memory
+/// otherwise. The view stays valid for the object's lifetime.
+class MappedFile final {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return m_ok; }
+    std::string_view getText() const {
+        return m_map != nullptr ? std::string_view(m_map, m_size) : std::string_view(m_fallback);
+    }
+
+private:
+    const char* m_map = nullptr;
+    size_t m_size = 0;
+    std::string m_fallback;
+    bool m_ok = false;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/// @brief Bounded lock-free multi-producer multi-consumer ring buffer (Dmitry Vyukov's design).
+/// Every cell carries a sequence number telling whose turn it is: a producer claims a cell by a
+/// CAS on the enqueue position, writes the value, then publishes it by bumping the sequence; a
+/// consumer does the mirror image. There is no lock, and producers only contend on one counter.
+///
+/// Bounded on purpose: when full, `tryPush()` fails and the producer decides whether to retry,
+/// drop or slow down, instead of the queue growing without limit.
+template <typename T>
+class MpmcQueue final {
+public:
+    /// @param capacity Rounded up to a power of two, at least 2.
+    explicit MpmcQueue(size_t capacity)
+        : m_mask(std::bit_ceil(capacity < 2 ? size_t(2) : capacity) - 1),
+          m_cells(std::make_unique<Cell[]>(m_mask + 1)) {
+        for (size_t i = 0; i <= m_mask; i++) {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /// @return false if the queue is full; `value` is left untouched then.
+    bool tryPush(T&& value) {
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[pos & m_mask];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                // The cell is free for this lap; claim it.
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // The consumer hasn't freed this cell from the previous lap yet.
+                return false;
+            } else {
+                // Another producer got here first.
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @return false if the queue is empty.
+    bool tryPop(T& out) {
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[pos & m_mask];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    // Hand the cell to the producer one lap ahead.
+                    cell.seq.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+    /// @brief Approximate while producers or consumers are active.
+    size_t sizeApprox() const {
+        size_t enqueued = m_enqueue_pos.load(std::memory_order_relaxed);
+        size_t dequeued = m_dequeue_pos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    static constexpr size_t K_CACHE_LINE = 64;
+
+    struct alignas(K_CACHE_LINE) Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    // Producers and consumers each get their own cache line.
+    alignas(K_CACHE_LINE) std::atomic<size_t> m_enqueue_pos = 0;
+    alignas(K_CACHE_LINE) std::atomic<size_t> m_dequeue_pos = 0;
+};
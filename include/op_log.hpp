@@ -0,0 +1,140 @@
+#pragma once
+
+#include "device_data.hpp"
+#include "sim_clock.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// @brief What a `OpRecord` reports. Each event has one text template in `appendRecordText()`.
+enum class OpEvent : uint8_t {
+    /// @brief "=====Name at HH:MM:SS=====" banner before a device session.
+    eSession = 0,
+    /// @brief End of one command: prints "<op> log: " plus the text of its other records.
+    eCommand = 1,
+    /// @brief A device ran without any command.
+    eEmptyLog = 2,
+    // DemoDevice
+    eHello = 3,
+    eSing = 4,
+    // AirFryer
+    eCookTooBig = 5,
+    eCookNoSpace = 6,
+    eCookDone = 7,
+    eCleanupDone = 8,
+    // WasherDryer
+    eClothTooMuch = 9,
+    eJobDone = 10,
+    eComboHandoff = 11,
+    // RealAC
+    eAcOpenTillDeg = 12,
+    eAcOpenForMins = 13,
+    // WasherDryer, added after the RealAC events to keep their on-disk values
+    eBinFull = 14,
+    // AirFryer, a request that fits but waits behind earlier ones in FIFO order
+    eCookQueued = 15,
+    // WasherDryer, a finished combo wash waiting for room in the dryer's bin
+    eComboWaits = 16,
+
+    COUNT,
+};
+// An event placed after `COUNT` or sharing its value would be out of range for every table and
+// decoder check sized by `COUNT`.
+static_assert(
+    std::ranges::max(magic_enum::enum_values<OpEvent>()) == OpEvent::COUNT &&
+        magic_enum::enum_name(OpEvent::COUNT) == "COUNT",
+    "COUNT must be greater than every other OpEvent"
+);
+
+/// @brief Fixed-size binary log record emitted by devices instead of formatting text.
+/// The meaning of the payload (`f0`, `f1`, `i0`, `str_id`, `flag`) depends on `event`.
+struct OpRecord {
+    /// @brief `SimClock` time of the event, in ns since its epoch.
+    int64_t time_ns = 0;
+    uint32_t device_id = 0;
+    /// @brief `DeviceData::cmd_id` of the command this record belongs to.
+    uint32_t cmd_id = 0;
+    float f0 = 0.f;
+    float f1 = 0.f;
+    int32_t i0 = 0;
+    /// @brief Index into `OpStringTable`, e.g. a device name or an AC mode.
+    uint32_t str_id = 0;
+    OpEvent event = OpEvent::eCommand;
+    uint8_t op_id = 0;
+    uint8_t mf_id = 0;
+    /// @brief e.g. heat vs cool, wash vs dry.
+    bool flag = false;
+
+    SimClock::time_point getTime() const {
+        return SimClock::time_point(std::chrono::nanoseconds(time_ns));
+    }
+    void setTime(SimClock::time_point t) {
+        time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+};
+static_assert(sizeof(OpRecord) == 40, "OpRecord is part of the on-disk format");
+static_assert(static_cast<uint32_t>(DeviceOpId::COUNT) <= UINT8_MAX);
+static_assert(static_cast<uint32_t>(DeviceMfId::COUNT) <= UINT8_MAX);
+
+/// @brief Interned strings referenced by `OpRecord::str_id`. Records stay fixed-size, and each
+/// distinct string is stored once. Ids are stable; lookups stay valid while the table lives.
+class OpStringTable final {
+public:
+    /// @brief Id 0 is always the empty string, the default `OpRecord::str_id`.
+    OpStringTable() { intern(""); }
+
+    /// @brief The process-wide table that devices intern into.
+    static OpStringTable& global();
+
+    uint32_t intern(std::string_view str);
+    std::string_view lookup(uint32_t id) const;
+    size_t size() const;
+
+private:
+    mutable std::mutex m_mutex;
+    /// @brief deque keeps element addresses stable, so string_views into it never dangle.
+    std::deque<std::string> m_strings;
+    std::unordered_map<std::string_view, uint32_t> m_ids;
+};
+
+/// @brief Append the human-readable text of a device record, e.g. "cleanup done at 12:00:00".
+/// Session, command and empty-log records are framing and add nothing here.
+void appendRecordText(std::string& out, const OpRecord& record, const OpStringTable& strings);
+
+/// @brief Streams records into a binary file:
+/// header ("SHOPLOG", version, record size), records, string table, footer offset.
+/// The string table is written by `close()`, so strings interned after a record still resolve.
+class OpLogWriter final {
+public:
+    static constexpr char K_MAGIC[8] = {'S', 'H', 'O', 'P', 'L', 'O', 'G', '\0'};
+    static constexpr uint32_t K_VERSION = 1;
+
+    ~OpLogWriter() { close(); }
+
+    bool open(const std::string& path);
+    void write(std::span<const OpRecord> records);
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+
+private:
+    std::FILE* m_file = nullptr;
+    std::mutex m_mutex;
+};
+
+/// @brief Reads a whole file written by `OpLogWriter`.
+/// @param records Output, in write order.
+/// @param strings Output, the file's string table.
+/// @return success; false on a missing file, bad magic, unsupported version, or a truncated or
+/// corrupt file, e.g. a table offset off the record grid or a string longer than the file.
+bool readOpLog(const std::string& path, std::vector<OpRecord>& records, OpStringTable& strings);
+
+/// @brief Render a record stream to today's text log, one line per banner or command.
+std::string renderOpLog(std::span<const OpRecord> records, const OpStringTable& strings);
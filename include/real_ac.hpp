@@ -6,22 +6,26 @@
 class RealAC : public Device {
 public:
     RealAC(uint32_t power) : Device("RealAC"), k_power(power) {};
+    RealAC(Identity identity, uint32_t power) : Device(std::move(identity)), k_power(power) {}
 
-    void operate(std::shared_ptr<DeviceData> data) override;
-    void malfunction(std::shared_ptr<DeviceData> data) override;
-    uint32_t timeTravel(const uint32_t duration_sec) override;
+    void operate(DeviceData* data) override;
+    void malfunction(DeviceData* data) override;
+    /// @brief Like `Device::operateBatch()`, but a run of back-to-back open commands only applies
+    /// the last one: each would settle the room, set the mode and restart the timer, undoing the
+    /// previous one with no time in between. The earlier ones are still logged and validated.
+    void operateBatch(std::span<DeviceData* const> batch) override;
+    DeviceKind getKind() const override { return DeviceKind::eRealAC; }
+    uint32_t timeTravel(const uint32_t duration_min) override;
+    void saveState(Checkpoint::Writer& out) const override;
+    bool loadState(Checkpoint::Reader& in) override;
 
-private:
-    /// @brief Assumption, a 1000w AC will cool or heat with rate 0.01 c/sec,
-    /// which is 0.6 c/min or 3 Celsius degree after 5 mins. But since we simulate
-    /// 1 min with 1 sec, it scales accordingly.
-    /// What we need is deg per sec per watt, and watt is joule/sec, thus it's 0.6/1000
-    static constexpr float K_DEG_PER_JOULE = 6e-4f;
-    // max power in watt
-    const uint32_t k_power;
+    uint32_t getMaxPower() const { return k_power; }
 
-    bool m_heat = false;
-    Timer m_timer;
+    /// @brief Assumption, a 1000w AC will cool or heat with rate 0.01 c/sec,
+    /// which is 0.6 c/min or 3 Celsius degree after 5 mins.
+    /// What we need is deg per sec per watt, and watt is joule/sec, thus it's 0.01/1000.
+    /// Seconds here are simulated seconds; `SimClock` takes care of the time scale.
+    static constexpr float K_DEG_PER_JOULE = 1e-5f;
 
     /// @brief Our AC can operates in 100%, 50%, and 25% mode.
     /// Their values are also used to shift max power which is hundreds to thousands watts.
@@ -29,30 +33,50 @@ private:
         eFull = 0,
         eMid = 1,
         eLow = 2,
-    } m_mode = Mode::eFull;
+    };
+
+private:
+    // max power in watt
+    const uint32_t k_power;
+
+    bool m_heat = false;
+    Timer<> m_timer;
+    /// @brief Seconds of the current session already added to the room by `updateTemp()`.
+    int m_applied_sec = 0;
+
+    Mode m_mode = Mode::eFull;
 
     bool setMode(std::string str);
 
     /// @brief Get actual power in watts modified by mode.
     inline float getPower() { return k_power >> static_cast<uint32_t>(m_mode); }
 
+    /// @brief Steps every open command shares: log the command with the current room temperature,
+    /// validate it, and settle the previous AC session.
+    void beginOpen(DeviceData* data);
+
+    /// @brief True for an open command whose malfunction leaves the AC as it is.
+    static bool isMergeableOpen(const DeviceData* data);
+
     /// @brief Async set AC open for certain mins.
-    ///
-    /// TODO: We spend 1 sec during execution on 1 min set by user. For now it is a implicit
-    /// conversion. Later we will manage this properly in `SmartManager`.
     /// @param data `dfloat`, `dint`, `dbool`, `dstring` fields should store
-    /// target temperature, duration (mins but actually executed in secs), heat or not, mode.
-    void openForMins(std::shared_ptr<DeviceData> data);
+    /// target temperature, duration in simulated minutes, heat or not, mode.
+    void openForMins(DeviceData* data);
 
     /// @brief Async set AC open till target degs.
-    ///
-    /// TODO: We spend 1 sec during execution on 1 min set by user. For now it is a implicit
-    /// conversion. Later we will manage this properly in `SmartManager`.
     /// @param data `dfloat`, `dint`, `dbool`, `dstring` fields should store
-    /// target temperature, duration (mins but actually executed in secs), heat or not, mode.
-    void openTillDeg(std::shared_ptr<DeviceData> data);
+    /// target temperature, duration in simulated minutes, heat or not, mode.
+    void openTillDeg(DeviceData* data);
 
     /// @brief Can be called at anytime after `openForMins()` and `openTillDeg()`.
     /// Besides updating temperature, it also stops the `Timer` if finished.
     void updateTemp();
+
+    /// @brief The session's end, so the room gets its heat when it happens, not at the next travel.
+    void wake() override { updateTemp(); }
+
+    static constexpr Capability::OpTable<RealAC> K_OP_TABLE = Capability::makeOpTable<RealAC>({
+        {DeviceOpId::eRealAcOpenTillDeg, &RealAC::openTillDeg},
+        {DeviceOpId::eRealAcOpenForMins, &RealAC::openForMins},
+    });
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/// @brief Fixed-capacity FIFO over one contiguous array. All memory is allocated by the
+/// constructor; `tryPush()` reports a full buffer instead of growing, so the owner decides what
+/// back-pressure means. Single-threaded, unlike `MpmcQueue`.
+template <typename T>
+class RingBuffer final {
+public:
+    /// @param capacity At least 1.
+    explicit RingBuffer(size_t capacity) : m_slots(capacity > 0 ? capacity : 1) {}
+
+    size_t capacity() const { return m_slots.size(); }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool full() const { return m_size == m_slots.size(); }
+
+    /// @brief The `index`-th item from the front, which is item 0. `index` must be below `size()`.
+    const T& operator[](size_t index) const { return m_slots[wrap(m_head + index)]; }
+
+    /// @brief Must not be empty.
+    T& front() { return m_slots[m_head]; }
+    const T& front() const { return m_slots[m_head]; }
+
+    /// @return false, leaving the buffer untouched, when it is full.
+    bool tryPush(const T& item) {
+        if (full())
+            return false;
+        m_slots[wrap(m_head + m_size)] = item;
+        m_size++;
+        return true;
+    }
+
+    /// @brief Must not be empty.
+    void popFront() {
+        m_head = wrap(m_head + 1);
+        m_size--;
+    }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_head = 0;
+    size_t m_size = 0;
+
+    /// @brief `index` is below twice the capacity, so one subtraction replaces a modulo.
+    size_t wrap(size_t index) const {
+        return index >= m_slots.size() ? index - m_slots.size() : index;
+    }
+};
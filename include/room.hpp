@@ -1,28 +1,55 @@
 #pragma once
 
+#include "logger.hpp"
+#include "sim_clock.hpp"
+
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <format>
-#include <iostream>
 #include <memory>
 #include <vector>
 
+/// @brief The world every `Device` shares through `Device::s_room`.
+///
+/// Temperature is a fixed-point `std::atomic<int64_t>` in micro-degrees rather than a `float`
+/// behind a lock: devices on any number of threads merge their deltas with a single lock-free
+/// `fetch_add`. Integer addition is exact and commutative, so no update is lost and the result
+/// doesn't depend on the order in which concurrent ACs land their deltas.
 class Room final {
 public:
     Room() = default;
-    Room(float temp) : m_temp(temp) {};
+    Room(float temp) : m_micro_deg(toMicroDeg(temp)) {};
 
     // Getter and setter: time should be retrieved on-the-fly and not be stored.
-    std::chrono::system_clock::time_point getTime() const {
-        return std::chrono::system_clock::now();
+    template <ClockPolicy Clock = SimClock>
+    typename Clock::time_point getTime() const {
+        return Clock::now();
+    }
+    void logTime() const { Log::info("{}", getTime()); }
+    float getTemp() const {
+        return static_cast<float>(
+            static_cast<double>(m_micro_deg.load(std::memory_order_relaxed)) / K_MICRO_PER_DEG
+        );
+    }
+    void setTemp(float temp) { m_micro_deg.store(toMicroDeg(temp), std::memory_order_relaxed); }
+    /// @brief Lock-free and exact up to 1e-6 degree per call, however many devices add at once.
+    void addTemp(float delta) {
+        m_micro_deg.fetch_add(toMicroDeg(delta), std::memory_order_relaxed);
     }
-    void logTime() const { std::cout << std::format("{}", getTime()) << std::endl; }
-    float getTemp() const { return m_temp; }
-    void setTemp(float temp) { m_temp = temp; }
     void logTemp() const {
-        std::cout << std::format("Temperature is {} Celsius degree", m_temp) << std::endl;
+        Log::info("Temperature is {} Celsius degree", getTemp());
     }
 
 private:
-    float m_temp;
+    static constexpr double K_MICRO_PER_DEG = 1e6;
+    static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+    std::atomic<int64_t> m_micro_deg = 0;
     // std::shared_ptr<SmartManager> m_sm;
+
+    static int64_t toMicroDeg(float deg) {
+        return std::llround(static_cast<double>(deg) * K_MICRO_PER_DEG);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <format>
+#include <limits>
+#include <ratio>
+#include <string>
+#include <thread>
+
+/// @brief Compile-time clock policy accepted by `Timer`, `Room::getTime()` and
+/// `Device::getCurrentTime()`. Any standard clock qualifies, as do the clocks below.
+template <typename Clock>
+concept ClockPolicy = requires {
+    typename Clock::duration;
+    typename Clock::time_point;
+    { Clock::now() } -> std::same_as<typename Clock::time_point>;
+};
+
+/// @brief How many simulated seconds pass per real second. Every `Device` duration (cook time,
+/// wash time, AC minutes, travel time) is in simulated minutes, so `K_MINUTE_PER_SEC` reproduces
+/// the original "1 minute = 1 second" behavior.
+namespace TimeScale {
+inline constexpr double K_REAL_TIME = 1.0;
+inline constexpr double K_MINUTE_PER_SEC = 60.0;
+inline constexpr double K_HOUR_PER_SEC = 3600.0;
+/// @brief Never sleep: `EventEngine` jumps the clock straight to the next event.
+inline constexpr double K_AS_FAST_AS_POSSIBLE = std::numeric_limits<double>::infinity();
+} // namespace TimeScale
+
+/// @brief The clock every `Device` reads. It satisfies the standard Clock requirements and shares
+/// `system_clock`'s epoch, so `std::format("{:%T}", ...)` keeps working on its time points.
+///
+/// Simulated time runs `TimeScale` times faster than the wall clock, and `sleepFor()` sleeps for
+/// the scaled-down real duration. With `K_AS_FAST_AS_POSSIBLE` time only moves when somebody calls
+/// `sleepFor()` or when `EventEngine` jumps to its next event, so waiting costs nothing.
+struct SimClock {
+    using duration = std::chrono::system_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::system_clock::time_point;
+    static constexpr bool is_steady = false;
+
+    static time_point now() {
+        if (isSimulated())
+            return s_sim_anchor;
+        std::chrono::duration<double, period> real =
+            std::chrono::system_clock::now() - s_real_anchor;
+        return s_sim_anchor + std::chrono::duration_cast<duration>(real * s_scale);
+    }
+
+    /// @brief Wait for `d` of simulated time: sleep `d / scale` of real time, or just move the
+    /// virtual clock forward when running as fast as possible.
+    static void sleepFor(duration d) {
+        if (d <= duration::zero())
+            return;
+        if (isSimulated())
+            s_sim_anchor += d;
+        else
+            std::this_thread::sleep_for(std::chrono::duration<double, period>(d) / s_scale);
+    }
+
+    /// @brief Change the time scale. Simulated time continues from where it is now, so the clock
+    /// never jumps when switching.
+    /// @param scale Simulated seconds per real second, see `TimeScale`. Must be positive.
+    static void setTimeScale(double scale) {
+        auto current = now();
+        s_scale = scale > 0.0 ? scale : TimeScale::K_REAL_TIME;
+        s_sim_anchor = current;
+        s_real_anchor = std::chrono::system_clock::now();
+    }
+    static double getTimeScale() { return s_scale; }
+
+    /// @brief True when running as fast as possible, i.e. purely on virtual time.
+    static bool isSimulated() { return s_scale == TimeScale::K_AS_FAST_AS_POSSIBLE; }
+
+    /// @brief Move the virtual clock to `t`. Never goes backwards; no-op when not simulated.
+    static void advanceTo(time_point t) {
+        if (isSimulated() && t > s_sim_anchor)
+            s_sim_anchor = t;
+    }
+
+    /// @brief Start the virtual clock over at `t`, e.g. to replay a recording at the times it was
+    /// made. Unlike `advanceTo()` it may go backwards; no-op when not simulated.
+    static void resetTo(time_point t) {
+        if (isSimulated())
+            s_sim_anchor = t;
+    }
+
+private:
+    inline static double s_scale = TimeScale::K_MINUTE_PER_SEC;
+    /// @brief `now()` is `s_sim_anchor + (wall now - s_real_anchor) * s_scale`. When simulated,
+    /// `s_sim_anchor` alone is the current time.
+    inline static time_point s_sim_anchor = std::chrono::system_clock::now();
+    inline static time_point s_real_anchor = s_sim_anchor;
+};
+
+/// @brief A clock that only moves when told to. Meant for unit tests and benchmarks: a `Timer`
+/// on it finishes in no time and without touching the global `SimClock`.
+struct ManualClock {
+    using duration = std::chrono::system_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::system_clock::time_point;
+    static constexpr bool is_steady = false;
+
+    static time_point now() { return s_now; }
+    static void advance(duration d) { s_now += d; }
+    static void set(time_point t) { s_now = t; }
+
+private:
+    inline static time_point s_now = {};
+};
+
+/// @brief `Base` running `Ratio` times faster than real time, e.g. `std::ratio<60>` turns one
+/// real second into one minute. Time starts scaling from the first `now()` call.
+template <ClockPolicy Base, typename Ratio>
+struct ScaledClock {
+    using duration = typename Base::duration;
+    using rep = typename duration::rep;
+    using period = typename duration::period;
+    using time_point = typename Base::time_point;
+    static constexpr bool is_steady = Base::is_steady;
+
+    static time_point now() {
+        static const time_point origin = Base::now();
+        auto elapsed = Base::now() - origin;
+        return origin + elapsed * Ratio::num / Ratio::den;
+    }
+};
+
+/// @brief Format `t` as "HH:MM:SS". Clocks without a calendar epoch (e.g. `steady_clock`) are
+/// printed as time since their epoch.
+template <ClockPolicy Clock>
+std::string formatClockTime(typename Clock::time_point t) {
+    if constexpr (std::same_as<typename Clock::time_point, std::chrono::system_clock::time_point>)
+        return std::format("{:%T}", t);
+    else
+        return std::format("{:%T}", t.time_since_epoch());
+}
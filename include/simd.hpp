@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/// @brief Thin portable SIMD layer: a float vector of `K_LANES` lanes and the handful of operations
+/// the stencil and fleet kernels need. The widest instruction set the compiler targets is picked at
+/// compile time (AVX/AVX2, SSE2, NEON), with a one-lane scalar fallback, so kernels are written
+/// once.
+/// Build with `-DSMARTHOME_NATIVE_ARCH=ON` to let x86 use AVX2.
+namespace Simd {
+
+#if defined(__AVX__)
+
+inline constexpr const char* K_BACKEND = "AVX";
+inline constexpr size_t K_LANES = 8;
+struct Float {
+    __m256 v;
+};
+inline Float load(const float* p) { return {_mm256_loadu_ps(p)}; }
+inline void store(float* p, Float a) { _mm256_storeu_ps(p, a.v); }
+inline Float broadcast(float x) { return {_mm256_set1_ps(x)}; }
+inline Float operator+(Float a, Float b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Float operator-(Float a, Float b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Float operator*(Float a, Float b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline Float min(Float a, Float b) { return {_mm256_min_ps(a.v, b.v)}; }
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+inline constexpr const char* K_BACKEND = "SSE2";
+inline constexpr size_t K_LANES = 4;
+struct Float {
+    __m128 v;
+};
+inline Float load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store(float* p, Float a) { _mm_storeu_ps(p, a.v); }
+inline Float broadcast(float x) { return {_mm_set1_ps(x)}; }
+inline Float operator+(Float a, Float b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float operator-(Float a, Float b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float operator*(Float a, Float b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Float min(Float a, Float b) { return {_mm_min_ps(a.v, b.v)}; }
+
+#elif defined(__ARM_NEON)
+
+inline constexpr const char* K_BACKEND = "NEON";
+inline constexpr size_t K_LANES = 4;
+struct Float {
+    float32x4_t v;
+};
+inline Float load(const float* p) { return {vld1q_f32(p)}; }
+inline void store(float* p, Float a) { vst1q_f32(p, a.v); }
+inline Float broadcast(float x) { return {vdupq_n_f32(x)}; }
+inline Float operator+(Float a, Float b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float operator-(Float a, Float b) { return {vsubq_f32(a.v, b.v)}; }
+inline Float operator*(Float a, Float b) { return {vmulq_f32(a.v, b.v)}; }
+inline Float min(Float a, Float b) { return {vminq_f32(a.v, b.v)}; }
+
+#else
+
+inline constexpr const char* K_BACKEND = "scalar";
+inline constexpr size_t K_LANES = 1;
+struct Float {
+    float v;
+};
+inline Float load(const float* p) { return {*p}; }
+inline void store(float* p, Float a) { *p = a.v; }
+inline Float broadcast(float x) { return {x}; }
+inline Float operator+(Float a, Float b) { return {a.v + b.v}; }
+inline Float operator-(Float a, Float b) { return {a.v - b.v}; }
+inline Float operator*(Float a, Float b) { return {a.v * b.v}; }
+inline Float min(Float a, Float b) { return {a.v < b.v ? a.v : b.v}; }
+
+#endif
+
+} // namespace Simd
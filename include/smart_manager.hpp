@@ -1,8 +1,16 @@
 #pragma once
 
+#include "command_log.hpp"
+#include "data_pool.hpp"
 #include "device.hpp"
+#include "event_engine.hpp"
+#include "mpmc_queue.hpp"
+#include "op_log.hpp"
+#include "thread_pool.hpp"
+#include "work_stealing_pool.hpp"
 
 #include <concepts> // perfect forwarding template type check
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -12,43 +20,193 @@
 /// std::move() to and hold exclusively by `SmartManager`.
 class SmartManager final {
 public:
+    /// @brief How parallel `operate()` spreads device sessions over workers.
+    enum class Scheduler : uint32_t {
+        /// @brief One shared FIFO queue.
+        eThreadPool = 0,
+        /// @brief Per-worker deques, idle workers steal. Best for uneven devices.
+        eWorkStealing = 1,
+    };
+
     /// @brief Transfer ownership of a `Device` to `SmartManager`
     /// @param device_ptr `Device` instance (will be MOVED FROM and invalidated)
-    /// @return success
-    bool addDevice(std::shared_ptr<Device>&& device_ptr);
+    /// @return The new device's id, or std::nullopt if its name is already taken.
+    std::optional<DeviceId> addDevice(std::shared_ptr<Device>&& device_ptr);
+
+    /// @brief Name lookup for callers outside; everything inside runs on `DeviceId`.
+    /// @param device_name Name the device had when it was added.
+    std::optional<DeviceId> findDevice(const std::string& device_name) const;
 
-    /// @brief Transfer ownership of a single `DeviceData` instance to `SmartManager`
-    /// @param device_name `Device` identifier
+    /// @brief Create an empty command in this manager's `DataPool`. Prefer it over
+    /// `std::make_shared<DeviceData>()`: no heap allocation per command, and the whole batch is
+    /// freed at once after `operate()`. Safe to call from any thread.
+    std::shared_ptr<DeviceData> createData() { return m_data_pool.make(); }
+
+    /// @brief Transfer ownership of a single `DeviceData` instance to `SmartManager`.
+    /// Commands the device can't handle (see `Capability`) are rejected here, not when operating.
+    /// @param id `Device` identifier
     /// @param data_ptr `DeviceData` instance (will be MOVED FROM and invalidated)
     /// @return success
-    bool addSingleData(std::string device_name, std::shared_ptr<DeviceData>&& data_ptr);
+    bool addSingleData(DeviceId id, std::shared_ptr<DeviceData>&& data_ptr);
+    bool addSingleData(const std::string& device_name, std::shared_ptr<DeviceData>&& data_ptr);
 
-    /// @brief Transfer ownership of a list of `DeviceData` to `SmartManager`
-    /// @param device_name `Device` identifier
+    /// @brief Transfer ownership of a list of `DeviceData` to `SmartManager`. All or nothing: if
+    /// any command is rejected, none is taken and `data` is left untouched.
+    /// @param id `Device` identifier
     /// @param data A vector of `DeviceData` instances (will be MOVED FROM and invalidated)
     /// @return success
-    bool addMultipleData(std::string device_name, DataList&& data);
+    bool addMultipleData(DeviceId id, DataList&& data);
+    bool addMultipleData(const std::string& device_name, DataList&& data);
+
+    /// @brief Capability check the functions above run on every command; logs why it is rejected.
+    /// @param id `Device` identifier, must exist
+    bool accepts(DeviceId id, const DeviceData& data) const;
+
+    /// @brief Submit a command from any thread, including while `operate()` runs, through a
+    /// bounded lock-free queue. It is picked up by the next `operate()`. Register every device
+    /// before producers start; ids are checked against the devices known at that point.
+    /// @param id `Device` identifier
+    /// @param data_ptr `DeviceData` instance, moved from only on success
+    /// @return false if the command is rejected or the queue is full; retry later in that case.
+    bool submit(DeviceId id, std::shared_ptr<DeviceData>&& data_ptr);
 
     /// @brief Transfer ownership of a single uint32_t travel time to `SmartManager`
-    /// @param device_name `Device` identifier
+    /// @param id `Device` identifier
     /// @param ttime uint32_t travel time instance (will be MOVED FROM and invalidated)
     /// @return success
-    bool addTravleTime(std::string device_name, uint32_t&& ttime);
+    bool addTravleTime(DeviceId id, uint32_t&& ttime);
+    bool addTravleTime(const std::string& device_name, uint32_t&& ttime);
 
     /// @brief Transfer ownership of a `Room` to `SmartManager`
     /// @param room `Room` instance (will be MOVED FROM and invalidated)
     void connectToRoom(std::shared_ptr<Room>&& room) { Device::loginRoom(std::move(room)); }
 
+    /// @brief Set how fast simulated time runs for every device, see `TimeScale`.
+    /// With `TimeScale::K_AS_FAST_AS_POSSIBLE`, devices run on the virtual `SimClock` driven by
+    /// `EventEngine`: devices advance through their own completion events, so no real time is
+    /// spent waiting, and sessions overlap in simulated time when `setParallel()` is on.
+    /// @param scale Simulated seconds per real second.
+    void setTimeScale(double scale) { SimClock::setTimeScale(scale); }
+
+    /// @brief Run devices concurrently on a fixed-size worker pool. Each device's commands still run
+    /// in order on a single worker, so wall time approaches the slowest device instead of the sum.
+    /// Parallelism only pays off when devices really wait. With `TimeScale::K_AS_FAST_AS_POSSIBLE`
+    /// no thread is used: every session starts at once in simulated time and the engine
+    /// interleaves them, while serial runs each one after the one before it is logged.
+    /// @param num_threads 0 or 1 to go back to serial execution.
+    /// @param scheduler How sessions are distributed over the workers.
+    void setParallel(size_t num_threads, Scheduler scheduler = Scheduler::eWorkStealing);
+
+    /// @brief Write compact binary `OpRecord`s to `path` instead of text operation logs.
+    /// No log text is formatted during `operate()`; render the file offline with
+    /// `SmartHomeLogDecode`. Warnings and errors still go to the text log.
+    /// @return success
+    bool setOpLog(const std::string& path) { return m_op_log.open(path); }
+
+    /// @brief Finish the binary log (writes its string table) and go back to text logs.
+    void closeOpLog() { m_op_log.close(); }
+
+    /// @brief Run every device on its pending data, then drop that data: each `DeviceData` is
+    /// consumed by exactly one `operate()`.
     void operate();
 
-    size_t getNumDevices() const { return m_device_map.size(); }
+    /// @brief Snapshot every device, pending command and travel time, plus the room temperature,
+    /// to `path` (see `Checkpoint`). Commands still in the `submit()` queue are taken in first.
+    /// The file is replaced atomically. Scheduler and op log settings aren't part of it.
+    /// @return success
+    bool saveCheckpoint(const std::string& path);
+
+    /// @brief Bring back a manager saved by `saveCheckpoint()`, by mapping the file and rebuilding
+    /// each device from it instead of replaying its commands. Running timers continue from
+    /// `SimClock::now()`. All or nothing: on a missing, corrupt or other-version file nothing
+    /// changes. Devices keep their saved names and ids, so restore into a fresh process.
+    /// @return false as well if this manager already has devices.
+    bool restoreCheckpoint(const std::string& path);
+
+    /// @brief Record this manager's state and, from then on, every device, command, travel time and
+    /// `operate()` it takes, each with its simulated time, to `path` (see `CommandLog`).
+    /// Commands from `submit()` are recorded when `operate()` picks them up. Restore checkpoints
+    /// before starting, not during a recording.
+    /// @return success
+    bool startRecording(const std::string& path);
+    void stopRecording() { m_recorder.close(); }
+
+    /// @brief Feed a recording back into this empty manager as fast as possible: switch to
+    /// `TimeScale::K_AS_FAST_AS_POSSIBLE`, put the virtual clock back to when recording started and
+    /// apply each event at its recorded time. Device names, ids, `cmd_id`s and times come out the
+    /// same, so when the original ran on the virtual clock too, the text log matches it byte for
+    /// byte. So does the binary op log when `OpStringTable::global()` gets the same strings in the
+    /// same order, e.g. replaying right after recording in the same process, or in a fresh one
+    /// when recording started on an empty manager. Commands rejected at submission weren't
+    /// recorded, so their errors aren't repeated.
+    /// @return false on a missing or corrupt recording, or as soon as the replay diverges.
+    bool replay(const std::string& path);
+
+    size_t getNumDevices() const { return m_devices.size(); }
 
 private:
-    std::vector<std::string> m_device_names;
-    /// @brief Name to Device
-    DeviceMap m_device_map;
-    /// @brief Name to a list of DeviceData
-    DataMap m_data_map;
-    /// @brief Name to `Device::timeTravel()` input
-    std::unordered_map<std::string, uint32_t> m_ttime_map;
+    /// @brief Backs `createData()`. Declared first so it is destroyed last, after the devices
+    /// that may still hold data.
+    DataPool m_data_pool;
+    /// @brief Name to `DeviceId`, only for the string overloads.
+    std::unordered_map<std::string, DeviceId> m_device_ids;
+    // Per-device state, all indexed by `DeviceId`.
+    std::vector<std::shared_ptr<Device>> m_devices;
+    /// @brief Cached `Device::getKind()` for the enqueue-time capability check.
+    std::vector<DeviceKind> m_kinds;
+    /// @brief Name at `addDevice()`. Unlike `Device::getName()`, which a hack rewrites during
+    /// `operate()`, it never changes, so `submit()` can log it from any thread.
+    std::vector<std::string> m_names;
+    /// @brief Pending data, consumed by the next `operate()`.
+    std::vector<DataList> m_data;
+    /// @brief `Device::timeTravel()` input
+    std::vector<uint32_t> m_ttimes;
+    /// @brief Device sessions and timers when running on the simulated clock. What finishes after
+    /// a round stays queued for the next one.
+    EventEngine m_engine;
+    /// @brief Workers for parallel `operate()`, nullptr when serial.
+    std::unique_ptr<TaskPool> m_pool;
+    /// @brief Binary operation log, text logs when not open.
+    OpLogWriter m_op_log;
+    /// @brief Next `DeviceData::cmd_id`.
+    uint32_t m_next_cmd_id = 0;
+    /// @brief Records everything fed to the manager while open.
+    CommandLog::Recorder m_recorder;
+
+    /// @brief A command waiting in `m_ingress`.
+    struct Command {
+        DeviceId id = 0;
+        std::shared_ptr<DeviceData> data;
+    };
+    static constexpr size_t K_INGRESS_CAPACITY = 4096;
+    /// @brief Commands from `submit()`, shared by all devices.
+    MpmcQueue<Command> m_ingress{K_INGRESS_CAPACITY};
+
+    /// @brief Move everything submitted so far to the per-device data lists.
+    void drainIngress();
+
+    /// @brief Everything one device needs for an `operate()` round. It is resolved up front, so a
+    /// session never touches the manager's vectors and can run on any thread.
+    struct Session {
+        Device* device;
+        /// @brief nullptr if the device has no data this round.
+        DataList* data;
+        /// @brief `data` as borrowed pointers, for `Device::operateBatch()`.
+        std::span<DeviceData* const> batch;
+        uint32_t ttime;
+    };
+    /// @brief Backing store of every `Session::batch`, reused across rounds.
+    std::vector<DeviceData*> m_batches;
+
+    /// @brief Operate, malfunction, time travel and log a single device, then call `done`. With
+    /// the engine attached, the log and `done` wait for the travel as events.
+    void operateDevice(const Session& session, EventEngine::Action done = nullptr);
+
+    /// @brief Devices, pending commands, travel times and room: the body of a checkpoint.
+    void writeState(Checkpoint::Writer& out) const;
+    /// @brief Counterpart of `writeState()` into this empty manager. All or nothing.
+    bool readState(Checkpoint::Reader& in);
+
+    /// @brief Append `data`, just given `cmd_id`, to the recording if there is one.
+    void recordCommand(DeviceId id, const DeviceData* data);
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief Optional spatial thermal model: a 2D grid of cells, each with its own temperature, heat
+/// sources (ACs) placed on cells, and heat diffusing between neighbors. Not wired into `Room` or
+/// `RealAC` yet: `Room` keeps its single scalar temperature and ACs still add to it directly.
+/// Driving a grid from the devices needs one owner advancing it, or concurrent ACs would step
+/// the same time twice; until then, callers own the grid and feed `setSourceRate()` themselves.
+///
+/// Each step is an explicit 5-point stencil, `T += D * dt * (left + right + up + down - 4T)`, with
+/// insulated walls: a ring of ghost cells mirrors the edge, so no heat leaves and the kernel has no
+/// branches. The stencil runs through `Simd`, `K_LANES` cells at a time.
+class ThermalGrid final {
+public:
+    enum class Kernel : uint32_t {
+        /// @brief One cell at a time, the reference implementation.
+        eScalar = 0,
+        /// @brief `Simd::K_LANES` cells at a time.
+        eSimd = 1,
+    };
+
+    /// @brief Cells squared per simulated second. Room air at ~0.5 m cells, roughly.
+    static constexpr float K_DEFAULT_DIFFUSIVITY = 0.02f;
+
+    /// @param width, height Number of cells, at least 1 each.
+    /// @param temp Initial temperature of every cell.
+    /// @param diffusivity Cells squared per simulated second.
+    ThermalGrid(
+        uint32_t width, uint32_t height, float temp, float diffusivity = K_DEFAULT_DIFFUSIVITY
+    );
+
+    uint32_t getWidth() const { return m_width; }
+    uint32_t getHeight() const { return m_height; }
+    float getTemp(uint32_t x, uint32_t y) const { return m_cur[index(x, y)]; }
+    void setTemp(uint32_t x, uint32_t y, float temp) { m_cur[index(x, y)] = temp; }
+    /// @brief Average over all cells, comparable to `Room::getTemp()`.
+    float getMeanTemp() const;
+
+    /// @brief Place a heat source, e.g. an AC, on cell (x, y). It starts idle.
+    /// @return Source index for `setSourceRate()`.
+    size_t addSource(uint32_t x, uint32_t y);
+    /// @brief Degrees per simulated second the source adds to its cell; negative cools.
+    void setSourceRate(size_t source, float deg_per_sec);
+
+    /// @brief Advance `seconds` of simulated time in as few steps as stability allows, so a long
+    /// time warp costs steps proportional to diffusivity, not to how the time was requested.
+    void advance(float seconds);
+
+    /// @brief A single step of `dt` simulated seconds; `dt * diffusivity` must not exceed
+    /// `K_MAX_STABLE_STEP` or the explicit scheme blows up.
+    void step(float dt);
+
+    void setKernel(Kernel kernel) { m_kernel = kernel; }
+
+    /// @brief Stability limit of the explicit 2D 5-point scheme.
+    static constexpr float K_MAX_STABLE_STEP = 0.25f;
+
+private:
+    uint32_t m_width;
+    uint32_t m_height;
+    /// @brief Row length including the left and right ghost cells.
+    size_t m_stride;
+    float m_diffusivity;
+    /// @brief Temperatures now and after the step being computed, ghost ring included.
+    std::vector<float> m_cur;
+    std::vector<float> m_next;
+
+    struct Source {
+        size_t cell;
+        float rate;
+    };
+    std::vector<Source> m_sources;
+    Kernel m_kernel = Kernel::eSimd;
+
+    size_t index(uint32_t x, uint32_t y) const { return (y + 1) * m_stride + x + 1; }
+
+    /// @brief Copy edge cells onto the ghost ring: zero flux through the walls.
+    void fillGhosts();
+    void diffuseScalar(float k);
+    void diffuseSimd(float k);
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/// @brief Interface of the worker pools behind `SmartManager`.
+/// Tasks are independent; ordering inside a task is up to the task itself, which is how
+/// `SmartManager` keeps per-device ordering: one device session is one task.
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+
+    virtual ~TaskPool() = default;
+
+    virtual void submit(Task task) = 0;
+
+    /// @brief Block until every submitted task has finished.
+    virtual void wait() = 0;
+
+    virtual size_t size() const = 0;
+};
+
+/// @brief A fixed-size pool of worker threads sharing one FIFO task queue.
+class ThreadPool final : public TaskPool {
+public:
+    /// @param num_threads Number of workers, at least 1.
+    explicit ThreadPool(size_t num_threads);
+    ~ThreadPool() override;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task) override;
+    void wait() override;
+    size_t size() const override { return m_workers.size(); }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<Task> m_tasks;
+    std::mutex m_mutex;
+    /// @brief Wakes workers when a task arrives or the pool stops.
+    std::condition_variable m_task_cv;
+    /// @brief Wakes `wait()` when the last task in flight finishes.
+    std::condition_variable m_idle_cv;
+    /// @brief Queued plus running tasks.
+    size_t m_in_flight = 0;
+    bool m_stop = false;
+
+    void workerLoop();
+};
@@ -1,44 +1,124 @@
 #pragma once
 
 #include "device.hpp"
-
-#include <deque>
+#include "ring_buffer.hpp"
 
 /// @brief A FIFO async Washer-Dryer twin.
 /// Unlike AirFryer, WashDryer should act atomically:
 /// User should NOT be able to add or take out cloth in the middle.
 ///
 /// "Async" in the sense that `Operate()` only submits the wash/dry job and returns immediately.
-/// `FinishAll()` should be called to really execute all waiting cloth in the bin when properly.
+/// A job submitted to a busy drum waits in its bin and starts when the one ahead finishes;
+/// `timeTravel()` is what runs them. Each bin is a fixed-capacity ring: a full bin rejects the
+/// job instead of growing. A combo whose wash is done while the dryer's bin is full stays in the
+/// washer, which stalls until a dry job finishes and makes room.
 class WasherDryer : public Device {
 public:
-    WasherDryer(float volume = 5.f) : Device("WasherDryer"), k_total_volume(volume) {}
-    WasherDryer(std::shared_ptr<DeviceData> data)
-        : Device("WasherDryer"), k_total_volume(data->dfloat) {}
-    ~WasherDryer() = default;
+    /// @brief Jobs per bin, the running one included.
+    static constexpr size_t K_DEFAULT_BIN_CAPACITY = 8;
+
+    WasherDryer(float volume = 5.f, size_t bin_capacity = K_DEFAULT_BIN_CAPACITY)
+        : Device("WasherDryer"), k_total_volume(volume), m_wash_bin(bin_capacity),
+          m_dry_bin(bin_capacity) {}
+    WasherDryer(const DeviceData& data)
+        : Device("WasherDryer"), k_total_volume(data.dfloat), m_wash_bin(K_DEFAULT_BIN_CAPACITY),
+          m_dry_bin(K_DEFAULT_BIN_CAPACITY) {}
+    WasherDryer(Identity identity, float volume, size_t bin_capacity)
+        : Device(std::move(identity)), k_total_volume(volume), m_wash_bin(bin_capacity),
+          m_dry_bin(bin_capacity) {}
 
-    void operate(std::shared_ptr<DeviceData> data) override;
-    void malfunction(std::shared_ptr<DeviceData> data) override;
-    uint32_t timeTravel(const uint32_t duration_sec) override;
+    void operate(DeviceData* data) override;
+    void malfunction(DeviceData* data) override;
+    /// @brief Jobs go into the bins in one pass. A job on a busy drum waits for the previous one,
+    /// so there is nothing to merge.
+    void operateBatch(std::span<DeviceData* const> batch) override {
+        operateEach<WasherDryer>(batch);
+    }
+    DeviceKind getKind() const override { return DeviceKind::eWasherDryer; }
+    /// @brief With `duration_min > 0`, moves the clock once, then settles every job that finished
+    /// inside the window from the timers alone, in finish order and without sleeping per job.
+    uint32_t timeTravel(const uint32_t duration_min) override;
+    void saveState(Checkpoint::Writer& out) const override;
+    bool loadState(Checkpoint::Reader& in) override;
+
+    float getTotalVolume() const { return k_total_volume; }
+    size_t getBinCapacity() const { return m_wash_bin.capacity(); }
 
 private:
     // a natural design for both having same volume
     const float k_total_volume;
-    Timer m_wash_timer = {};
-    Timer m_dry_timer = {};
-    std::deque<std::shared_ptr<DeviceData>> m_wash_bin;
-    std::deque<std::shared_ptr<DeviceData>> m_dry_bin;
+    Timer<> m_wash_timer = {};
+    Timer<> m_dry_timer = {};
+
+    /// @brief What a bin keeps of a command: enough to time and log the job. Queued jobs outlive
+    /// `operate()`, so they are copied out of the `DeviceData` rather than pointing at it.
+    struct Job {
+        uint32_t cmd_id;
+        DeviceOpId op_id;
+        DeviceMfId mf_id;
+        int minutes;
+    };
+    /// @brief The front job is the running one, or a stalled combo, the rest wait in order.
+    RingBuffer<Job> m_wash_bin;
+    RingBuffer<Job> m_dry_bin;
 
     /// @brief Async Wash operation.
-    /// 1. add input wash data to bin.
-    /// 2. [if washer occupied now] sim running wash till the end and finish up.
-    /// 3. [if wash just finished is a wash-dry combo] submit to dryer.
-    /// 4. submit input wash.
-    /// @param data NOTE: `data->success` stores result of itself, not of finished previous wash.
-    void wash(std::shared_ptr<DeviceData> data);
+    /// 1. [if cloth too much or bin full] reject.
+    /// 2. add input wash job to bin.
+    /// 3. [if washer idle] start it now, otherwise it starts when the jobs ahead finish.
+    /// A finished wash-dry combo moves on to the dryer's bin.
+    /// @param data NOTE: `data->success` stores whether the job was accepted. Its completion is
+    /// logged when it happens, possibly in a later session.
+    void wash(DeviceData* data);
+
+    /// @brief Async Dry operation, works the same as `Wash()`.
+    void dry(DeviceData* data);
+
+    /// @brief Shared by `wash()` and `dry()`.
+    void submit(bool is_wash, DeviceData* data);
+
+    /// @brief Sim the running job of the washer or dryer till the end and settle it, then run
+    /// `then`.
+    void performNext(bool is_wash, EventEngine::Action then);
+
+    /// @brief Start the front job of a bin at `at` and wake up when it is done.
+    void start(bool is_wash, SimClock::time_point at);
+
+    /// @brief Settle every job that finishes by `end`, in finish order.
+    void settleUntil(SimClock::time_point end);
+
+    void wake() override { settleUntil(SimClock::now()); }
+
+    /// @brief Finish the front job of a bin at `done`: log it and `release()` it, unless it is a
+    /// combo wash facing a full dryer bin, which stalls the washer instead. A dry job leaving
+    /// releases a stalled combo into the room it made.
+    void settle(bool is_wash, SimClock::time_point done);
+
+    /// @brief Take the front job out of its bin at `done`, start the next one there at `done` and
+    /// hand a combo wash to the dryer.
+    void release(bool is_wash, SimClock::time_point done);
+
+    /// @brief A finished combo wash joins the dryer's bin, which must have room. It starts at
+    /// `done` if the dryer is idle, otherwise `settle()` starts it when the job ahead finishes.
+    void handOff(const Job& job, SimClock::time_point done);
+
+    /// @brief A finished combo wash is waiting for the dryer: it stays at the front of the wash
+    /// bin with the timer stopped, which is also how a checkpoint keeps it.
+    bool isWashStalled() const { return !m_wash_bin.empty() && !m_wash_timer.running; }
+
+    OpRecord& emit(const Job& job, OpEvent event, SimClock::time_point time) {
+        return Device::emit(job.cmd_id, job.op_id, job.mf_id, event, time);
+    }
+    using Device::emit;
 
-    /// @brief Async Dry operation, works the same as `Wash()` except for step 3.
-    void dry(std::shared_ptr<DeviceData> data);
+    /// @brief When the running job of the washer or dryer finishes, `time_point::max()` if idle.
+    SimClock::time_point getFinishTime(bool is_wash) const;
 
-    void performNext(bool is_wash);
+    static constexpr Capability::OpTable<WasherDryer> K_OP_TABLE =
+        Capability::makeOpTable<WasherDryer>({
+            // auto call dry() after wash() finishes
+            {DeviceOpId::eWashDryerCombo, &WasherDryer::wash},
+            {DeviceOpId::eWashDryerWashOnly, &WasherDryer::wash},
+            {DeviceOpId::eWashDryerDryOnly, &WasherDryer::dry},
+        });
 };
\ No newline at end of file
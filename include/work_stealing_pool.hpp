@@ -0,0 +1,62 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+/// @brief A fixed-size pool where every worker owns a deque of tasks.
+/// A worker pops its own deque from the back (LIFO, cache-warm) and, once empty, steals from the
+/// front of the others (FIFO, oldest and likely biggest work first). Uneven tasks, like an instant
+/// `DemoDevice::hello` next to a chained `WasherDryer` combo, are balanced dynamically instead of
+/// leaving cores idle behind a static partition.
+class WorkStealingPool final : public TaskPool {
+public:
+    /// @param num_threads Number of workers, at least 1.
+    explicit WorkStealingPool(size_t num_threads);
+    ~WorkStealingPool() override;
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /// @brief From a worker of this pool, push to its own deque; otherwise spread round-robin.
+    void submit(Task task) override;
+    void wait() override;
+    size_t size() const override { return m_threads.size(); }
+
+    /// @brief How many tasks were taken from another worker's deque so far.
+    uint64_t getStealCount() const { return m_steal_count.load(std::memory_order_relaxed); }
+
+private:
+    /// @brief A mutex per deque keeps contention local: the owner and at most a thief or two.
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    /// @brief Round-robin cursor for submissions from outside the pool.
+    std::atomic<size_t> m_next_queue = 0;
+    /// @brief Queued tasks not yet taken by any worker.
+    std::atomic<size_t> m_queued = 0;
+    /// @brief Queued plus running tasks.
+    std::atomic<size_t> m_in_flight = 0;
+    std::atomic<uint64_t> m_steal_count = 0;
+
+    /// @brief Guards sleeping and waking only; the deques have their own locks.
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_task_cv;
+    std::condition_variable m_idle_cv;
+    bool m_stop = false;
+
+    /// @brief Which pool and which deque the current thread works for, if any.
+    inline static thread_local WorkStealingPool* t_pool = nullptr;
+    inline static thread_local size_t t_index = 0;
+
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t thief, Task& task);
+    void workerLoop(size_t index);
+};
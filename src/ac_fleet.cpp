@@ -0,0 +1,75 @@
+#include "ac_fleet.hpp"
+#include "simd.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+AcFleet::RoomId AcFleet::addRoom(float temp) {
+    m_room_temp.push_back(temp);
+    return static_cast<RoomId>(m_room_temp.size() - 1);
+}
+
+AcFleet::UnitId AcFleet::addUnit(RoomId room, uint32_t power) {
+    Debug::logAssert(room < m_room_temp.size(), "AcFleet::addUnit(), no room {}", room);
+    m_rate.push_back(0.f);
+    m_remaining_sec.push_back(0.f);
+    m_room.push_back(room);
+    m_power.push_back(power);
+    return static_cast<UnitId>(m_rate.size() - 1);
+}
+
+void AcFleet::reserve(size_t num_units) {
+    m_rate.reserve(num_units);
+    m_remaining_sec.reserve(num_units);
+    m_room.reserve(num_units);
+    m_power.reserve(num_units);
+}
+
+float AcFleet::getRate(UnitId unit, Mode mode) const {
+    auto power = static_cast<float>(m_power[unit] >> static_cast<uint32_t>(mode));
+    return RealAC::K_DEG_PER_JOULE * power;
+}
+
+void AcFleet::openForMins(UnitId unit, uint32_t mins, bool heat, Mode mode) {
+    m_rate[unit] = (heat ? 1.f : -1.f) * getRate(unit, mode);
+    m_remaining_sec[unit] = static_cast<float>(mins * 60);
+}
+
+void AcFleet::openTillDeg(UnitId unit, float target, Mode mode) {
+    float rate = getRate(unit, mode);
+    float delta_temp = target - m_room_temp[m_room[unit]];
+    m_rate[unit] = delta_temp > 0.f ? rate : -rate;
+    // Whole seconds, like `RealAC::openTillDeg()`; a unit with no power at `mode` stays idle.
+    m_remaining_sec[unit] = rate > 0.f ? std::floor(std::abs(delta_temp) / rate) : 0.f;
+}
+
+void AcFleet::advance(float seconds) {
+    if (seconds <= 0.f)
+        return;
+
+    const auto dt = Simd::broadcast(seconds);
+    const float* rate = m_rate.data();
+    float* remaining = m_remaining_sec.data();
+    const RoomId* room = m_room.data();
+    float* room_temp = m_room_temp.data();
+    const size_t n = size();
+
+    size_t i = 0;
+    // Units in a vector may share a room, so the room update is a scalar scatter of each lane.
+    float delta[Simd::K_LANES];
+    for (; i + Simd::K_LANES <= n; i += Simd::K_LANES) {
+        auto left = Simd::load(remaining + i);
+        auto active = Simd::min(left, dt);
+        Simd::store(remaining + i, left - active);
+        Simd::store(delta, Simd::load(rate + i) * active);
+        for (size_t lane = 0; lane < Simd::K_LANES; lane++) {
+            room_temp[room[i + lane]] += delta[lane];
+        }
+    }
+    for (; i < n; i++) {
+        float active = std::min(remaining[i], seconds);
+        remaining[i] -= active;
+        room_temp[room[i]] += rate[i] * active;
+    }
+}
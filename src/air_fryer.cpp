@@ -1,26 +1,17 @@
 #include "air_fryer.hpp"
+#include "checkpoint.hpp"
 
-#include <thread>
+#include <algorithm>
 
-void AirFryer::operate(std::shared_ptr<DeviceData> data) {
+void AirFryer::operate(DeviceData* data) {
+    static_assert(Capability::handlesOnlyAccepted(K_OP_TABLE, DeviceKind::eAirFryer));
     if (data == nullptr || !m_on)
         return;
 
-    switch (data->op_id) {
-    case DeviceOpId::eAirFryerCook:
-        cook(data);
-        break;
-    case DeviceOpId::eAirFryerClean:
-        cleanup(data);
-        break;
-    default:
-        Device::operate();
-        data->logOpId();
-        break;
-    }
+    dispatch(K_OP_TABLE, data);
 }
 
-void AirFryer::malfunction(std::shared_ptr<DeviceData> data) {
+void AirFryer::malfunction(DeviceData* data) {
     if (data == nullptr || !m_on)
         return;
 
@@ -33,7 +24,7 @@ void AirFryer::malfunction(std::shared_ptr<DeviceData> data) {
         hackName("Evil", 3);
         break;
     case DeviceMfId::eBroken:
-        std::cerr << getName() << " is buring! BOOM! Buy a new one!" << std::endl;
+        Log::error("{} is buring! BOOM! Buy a new one!", getName());
         break;
     default:
         // eNormal
@@ -42,37 +33,226 @@ void AirFryer::malfunction(std::shared_ptr<DeviceData> data) {
     }
 }
 
-void AirFryer::cook(std::shared_ptr<DeviceData> data) {
+uint32_t AirFryer::timeTravel(const uint32_t duration_min) {
+    using namespace std::chrono;
+    if (duration_min > 0) {
+        auto end = SimClock::now() + minutes(duration_min);
+        travelFor(minutes(duration_min), [this, end] { finishUntil(end); });
+        return duration_min;
+    }
+
+    auto start = SimClock::now();
+    cookUntilEmpty([] {});
+    return duration_cast<minutes>(SimClock::now() - start).count();
+}
+
+void AirFryer::cookUntilEmpty(EventEngine::Action then) {
+    if (m_cooking.empty()) {
+        then();
+        return;
+    }
+    // Items admitted on the way may finish later still, so look again once there.
+    auto last_done = m_last_done;
+    travelFor(last_done - SimClock::now(), [this, last_done, then = std::move(then)] {
+        finishUntil(last_done);
+        cookUntilEmpty(std::move(then));
+    });
+}
+
+AirFryer::CookStats AirFryer::getStats() const {
+    using namespace std::chrono;
+    auto now = std::max(SimClock::now(), m_stats_until);
+    double occupied = m_occupied_integral +
+                      (k_total_volume - m_volume) *
+                          duration<double, std::ratio<60>>(now - m_stats_until).count();
+    double elapsed_min = duration<double, std::ratio<60>>(now - m_stats_since).count();
+
+    CookStats stats;
+    stats.cooked = m_cooked;
+    stats.queued = m_queued;
+    stats.pending = m_pending.size();
+    if (elapsed_min > 0.0)
+        stats.utilization = static_cast<float>(occupied / (k_total_volume * elapsed_min));
+    if (m_started > 0)
+        stats.mean_wait_min = static_cast<float>(m_total_wait_min / m_started);
+    stats.max_wait_min = static_cast<float>(m_max_wait_min);
+    return stats;
+}
+
+void AirFryer::resetStats() {
+    m_stats_since = std::max(SimClock::now(), m_stats_until);
+    m_stats_until = m_stats_since;
+    m_occupied_integral = 0.0;
+    m_cooked = m_started = m_queued = 0;
+    m_total_wait_min = m_max_wait_min = 0.0;
+}
+
+void AirFryer::cook(DeviceData* data) {
     // caller Operate() should filter out nullptr input
     Debug::logAssert(data != nullptr, "caller Operate() should filter out nullptr input");
     float food_volume = data->dfloat;
     Debug::logAssert(food_volume > 0.f, "Food Volume shoud be positive, got %.3f", food_volume);
-    auto time_sec = data->dint;
+    auto now = SimClock::now();
 
+    // Items that are done by now free their space first.
+    finishUntil(now);
     if (food_volume > k_total_volume) {
-        data->dstring = std::format(
-            "Food volume {} bigger than total volume {}. Buy a bigger one!",
-            food_volume,
-            k_total_volume
-        );
-        data->success = false;
-    } else if (food_volume > m_volume) {
-        data->dstring = std::format(
-            "Food volume {} bigger than current volume {}. Wait for more space.",
-            food_volume,
-            m_volume
-        );
+        auto& record = emit(*data, OpEvent::eCookTooBig);
+        record.f0 = food_volume;
+        record.f1 = k_total_volume;
         data->success = false;
+        return;
+    }
+
+    Request request = {now, food_volume, data->dint, data->cmd_id, data->mf_id};
+    // Anything already queued didn't fit, so only FIFO makes a fitting newcomer wait.
+    bool blocked = m_admission == Admission::eFifo && !m_pending.empty();
+    if (food_volume <= m_volume && !blocked) {
+        start(request, now);
+    } else {
+        // It fits, so it only waits for the requests ahead of it.
+        bool queued = food_volume <= m_volume;
+        auto& record = emit(*data, queued ? OpEvent::eCookQueued : OpEvent::eCookNoSpace);
+        record.f0 = food_volume;
+        record.f1 = m_volume;
+        if (queued)
+            record.i0 = static_cast<int32_t>(m_pending.size());
+        auto pos = m_pending.end();
+        if (m_admission == Admission::eFirstFitDecreasing) {
+            pos = std::upper_bound(
+                m_pending.begin(),
+                m_pending.end(),
+                food_volume,
+                [](float volume, const Request& other) { return volume > other.volume; }
+            );
+        }
+        m_pending.insert(pos, request);
+        m_queued++;
     }
-    m_volume -= food_volume;
-    std::this_thread::sleep_for(std::chrono::seconds(time_sec));
-    data->dstring =
-        std::format("completes cooking after {} seconds at {}", time_sec, getCurrentTime());
+    // Accepted: it cooks now or as soon as there is space.
     data->success = true;
 }
 
-void AirFryer::cleanup(std::shared_ptr<DeviceData> data) {
-    m_volume = k_total_volume;
+void AirFryer::cleanup(DeviceData* data) {
+    // Can't clean the basket with food in it: finish cooking first.
     data->success = true;
-    data->dstring = std::format("cleanup done at {}", getCurrentTime());
+    cookUntilEmpty([this, cmd_id = data->cmd_id, mf_id = data->mf_id] {
+        m_volume = k_total_volume;
+        emit(cmd_id, DeviceOpId::eAirFryerClean, mf_id, OpEvent::eCleanupDone);
+    });
+}
+
+void AirFryer::finishUntil(SimClock::time_point until) {
+    while (!m_cooking.empty() && m_cooking.top().done <= until) {
+        Item item = m_cooking.top();
+        m_cooking.pop();
+        accountUntil(item.done);
+        emit(item.cmd_id, DeviceOpId::eAirFryerCook, item.mf_id, OpEvent::eCookDone, item.done)
+            .i0 = item.minutes;
+        m_volume += item.volume;
+        m_cooked++;
+        // Don't let float error leak space once the basket is empty.
+        if (m_cooking.empty())
+            m_volume = k_total_volume;
+
+        admitPending(item.done);
+    }
+}
+
+void AirFryer::admitPending(SimClock::time_point at) {
+    auto it = m_pending.begin();
+    while (it != m_pending.end()) {
+        if (it->volume <= m_volume) {
+            start(*it, at);
+            it = m_pending.erase(it);
+        } else if (m_admission == Admission::eFifo) {
+            break;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void AirFryer::start(const Request& request, SimClock::time_point at) {
+    accountUntil(at);
+    m_volume -= request.volume;
+    auto done = at + std::chrono::minutes(request.minutes);
+    m_cooking.push({done, request.volume, request.minutes, request.cmd_id, request.mf_id});
+    m_last_done = std::max(m_last_done, done);
+    wakeAt(done);
+
+    double wait_min =
+        std::chrono::duration<double, std::ratio<60>>(at - request.requested).count();
+    m_started++;
+    m_total_wait_min += wait_min;
+    m_max_wait_min = std::max(m_max_wait_min, wait_min);
+}
+
+void AirFryer::accountUntil(SimClock::time_point t) {
+    if (t <= m_stats_until)
+        return;
+    m_occupied_integral += (k_total_volume - m_volume) *
+                           std::chrono::duration<double, std::ratio<60>>(t - m_stats_until).count();
+    m_stats_until = t;
+}
+
+void AirFryer::saveState(Checkpoint::Writer& out) const {
+    Device::saveState(out);
+    out.put(m_volume);
+    out.putTime(m_last_done);
+    // The heap can't be walked in place; popping a copy writes the items in finish order.
+    auto cooking = m_cooking;
+    out.put(static_cast<uint32_t>(cooking.size()));
+    for (; !cooking.empty(); cooking.pop()) {
+        const auto& item = cooking.top();
+        out.putTime(item.done);
+        out.put(item.volume);
+        out.put(item.minutes);
+        out.put(item.cmd_id);
+        out.put(item.mf_id);
+    }
+    out.put(static_cast<uint32_t>(m_pending.size()));
+    for (const auto& request : m_pending) {
+        out.putTime(request.requested);
+        out.put(request.volume);
+        out.put(request.minutes);
+        out.put(request.cmd_id);
+        out.put(request.mf_id);
+    }
+    out.put(m_admission);
+    out.putTime(m_stats_since);
+    out.putTime(m_stats_until);
+    out.put(m_occupied_integral);
+    out.put(m_cooked);
+    out.put(m_started);
+    out.put(m_queued);
+    out.put(m_total_wait_min);
+    out.put(m_max_wait_min);
+}
+
+bool AirFryer::loadState(Checkpoint::Reader& in) {
+    uint32_t count = 0;
+    if (!Device::loadState(in) || !in.get(m_volume) || !in.getTime(m_last_done) || !in.get(count))
+        return false;
+    m_cooking = {};
+    for (uint32_t i = 0; i < count; i++) {
+        Item item;
+        if (!in.getTime(item.done) || !in.get(item.volume) || !in.get(item.minutes) ||
+            !in.get(item.cmd_id) || !in.getEnum(item.mf_id))
+            return false;
+        m_cooking.push(item);
+    }
+    if (!in.get(count))
+        return false;
+    m_pending.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        Request request;
+        if (!in.getTime(request.requested) || !in.get(request.volume) ||
+            !in.get(request.minutes) || !in.get(request.cmd_id) || !in.getEnum(request.mf_id))
+            return false;
+        m_pending.push_back(request);
+    }
+    return in.getEnum(m_admission) && in.getTime(m_stats_since) && in.getTime(m_stats_until) &&
+           in.get(m_occupied_integral) && in.get(m_cooked) && in.get(m_started) &&
+           in.get(m_queued) && in.get(m_total_wait_min) && in.get(m_max_wait_min);
 }
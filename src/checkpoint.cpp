@@ -0,0 +1,208 @@
+#include "checkpoint.hpp"
+#include "air_fryer.hpp"
+#include "real_ac.hpp"
+#include "washer_dryer.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace Checkpoint {
+
+void Writer::putString(std::string_view str) {
+    put(static_cast<uint32_t>(str.size()));
+    m_bytes.insert(m_bytes.end(), str.begin(), str.end());
+}
+
+void Writer::putTimer(const Timer<>& timer) {
+    putTime(timer.t_start);
+    put(timer.t_total_sec.count());
+    put(timer.running);
+}
+
+void Writer::putData(const DeviceData& data) {
+    put(data.cmd_id);
+    put(data.op_id);
+    put(data.mf_id);
+    put(data.dfloat);
+    put(data.dint);
+    put(data.dbool);
+    putString(data.dstring);
+}
+
+bool Writer::commit(const std::string& path) const {
+    std::string temp_path = path + ".tmp";
+#if !defined(_WIN32)
+    int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        Log::error("Can't create checkpoint {}", temp_path);
+        return false;
+    }
+    const char* data = m_bytes.data();
+    size_t left = m_bytes.size();
+    while (left > 0) {
+        auto written = ::write(fd, data, left);
+        if (written <= 0)
+            break;
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    bool ok = left == 0 && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    ok = ok && std::rename(temp_path.c_str(), path.c_str()) == 0;
+    if (ok) {
+        // The rename itself is only durable once the directory entry is on disk too.
+        auto dir = std::filesystem::path(path).parent_path();
+        int dir_fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+        bool synced = dir_fd >= 0 && ::fsync(dir_fd) == 0;
+        if (dir_fd >= 0)
+            synced = ::close(dir_fd) == 0 && synced;
+        if (!synced)
+            Log::error("Failed to sync the directory of checkpoint {}", path);
+        // `path` is already replaced, so there is no temporary file left to remove.
+        return synced;
+    }
+#else
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    file.write(m_bytes.data(), static_cast<std::streamsize>(m_bytes.size()));
+    file.close();
+    std::error_code error;
+    bool ok = file.good();
+    if (ok)
+        std::filesystem::rename(temp_path, path, error);
+    ok = ok && !error;
+#endif
+    if (!ok) {
+        Log::error("Failed to write checkpoint {}", path);
+        std::remove(temp_path.c_str());
+    }
+    return ok;
+}
+
+bool Reader::getString(std::string& str) {
+    uint32_t size = 0;
+    if (!get(size) || m_rest.size() < size)
+        return m_ok = false;
+    str.assign(m_rest.substr(0, size));
+    m_rest.remove_prefix(size);
+    return true;
+}
+
+bool Reader::getTime(SimClock::time_point& t) {
+    SimClock::rep offset = 0;
+    if (!get(offset))
+        return false;
+    // Saturate instead of overflowing for far-off times, e.g. a default-constructed time point.
+    using limits = std::numeric_limits<SimClock::rep>;
+    auto base = m_now.time_since_epoch().count();
+    if (offset > 0 && base > limits::max() - offset)
+        t = SimClock::time_point::max();
+    else if (offset < 0 && base < limits::min() - offset)
+        t = SimClock::time_point::min();
+    else
+        t = m_now + SimClock::duration(offset);
+    return true;
+}
+
+bool Reader::getTimer(Timer<>& timer) {
+    std::chrono::seconds::rep total_sec = 0;
+    if (!getTime(timer.t_start) || !get(total_sec) || !get(timer.running))
+        return false;
+    timer.t_total_sec = std::chrono::seconds(total_sec);
+    return true;
+}
+
+bool Reader::getData(DeviceData& data) {
+    return get(data.cmd_id) && getEnum(data.op_id) && getEnum(data.mf_id) && get(data.dfloat) &&
+           get(data.dint) && get(data.dbool) && getString(data.dstring);
+}
+
+void writeDevice(Writer& out, const Device& device) {
+    auto kind = device.getKind();
+    out.put(kind);
+    switch (kind) {
+    case DeviceKind::eAirFryer:
+        out.put(static_cast<const AirFryer&>(device).getTotalVolume());
+        break;
+    case DeviceKind::eWasherDryer: {
+        const auto& washer_dryer = static_cast<const WasherDryer&>(device);
+        out.put(washer_dryer.getTotalVolume());
+        out.put(static_cast<uint64_t>(washer_dryer.getBinCapacity()));
+        break;
+    }
+    case DeviceKind::eRealAC:
+        out.put(static_cast<const RealAC&>(device).getMaxPower());
+        break;
+    default:
+        // The name is part of `Device::saveState()`.
+        break;
+    }
+    device.saveState(out);
+}
+
+std::shared_ptr<Device> readDevice(Reader& in) {
+    DeviceKind kind;
+    float volume = 0.f;
+    uint64_t bin_capacity = 0;
+    uint32_t power = 0;
+    if (!in.getEnum(kind))
+        return nullptr;
+    // Constructor arguments; a failed read fails every later one, the peek below included.
+    switch (kind) {
+    case DeviceKind::eAirFryer:
+        in.get(volume);
+        break;
+    case DeviceKind::eWasherDryer:
+        in.get(volume);
+        in.get(bin_capacity);
+        break;
+    case DeviceKind::eRealAC:
+        in.get(power);
+        break;
+    default:
+        // The name is part of `Device::saveState()`.
+        break;
+    }
+
+    // Peek at the name and id `Device::loadState()` reads next, so the device is built with them
+    // instead of interning a placeholder name and taking a fresh id.
+    Reader peek = in;
+    Device::Identity identity;
+    if (!peek.getString(identity.name) || !peek.get(identity.id))
+        return nullptr;
+
+    std::shared_ptr<Device> device;
+    switch (kind) {
+    case DeviceKind::eDevice:
+        device = std::make_shared<Device>(std::move(identity));
+        break;
+    case DeviceKind::eDemoDevice:
+        device = std::make_shared<DemoDevice>(std::move(identity));
+        break;
+    case DeviceKind::eAirFryer:
+        device = std::make_shared<AirFryer>(std::move(identity), volume);
+        break;
+    case DeviceKind::eWasherDryer:
+        device = std::make_shared<WasherDryer>(
+            std::move(identity), volume, static_cast<size_t>(bin_capacity)
+        );
+        break;
+    case DeviceKind::eRealAC:
+        device = std::make_shared<RealAC>(std::move(identity), power);
+        break;
+    default:
+        break;
+    }
+    if (device == nullptr || !device->loadState(in))
+        return nullptr;
+    return device;
+}
+
+} // namespace Checkpoint
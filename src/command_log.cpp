@@ -0,0 +1,42 @@
+#include "command_log.hpp"
+
+namespace CommandLog {
+
+bool Recorder::open(const std::string& path) {
+    close();
+    m_file = std::fopen(path.c_str(), "wb");
+    if (m_file == nullptr)
+        return false;
+
+    m_event.emplace();
+    auto start = m_event->getTimeBase().time_since_epoch().count();
+    std::fwrite(K_MAGIC, 1, sizeof(K_MAGIC), m_file);
+    std::fwrite(&K_VERSION, sizeof(K_VERSION), 1, m_file);
+    std::fwrite(&start, sizeof(start), 1, m_file);
+    return true;
+}
+
+void Recorder::close() {
+    if (m_file == nullptr)
+        return;
+    std::fclose(m_file);
+    m_file = nullptr;
+    m_event.reset();
+}
+
+Checkpoint::Writer& Recorder::begin(Event event) {
+    m_event->clear();
+    m_event->put(event);
+    m_event->putTime(SimClock::now());
+    m_last = event;
+    return *m_event;
+}
+
+void Recorder::end() {
+    auto bytes = m_event->getBytes();
+    std::fwrite(bytes.data(), 1, bytes.size(), m_file);
+    if (m_last == Event::eOperate)
+        std::fflush(m_file);
+}
+
+} // namespace CommandLog
@@ -0,0 +1,247 @@
+#include "config_loader.hpp"
+#include "air_fryer.hpp"
+#include "mapped_file.hpp"
+#include "real_ac.hpp"
+#include "washer_dryer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+/// @brief `magic_enum` names of `E`, sorted once at compile time, so a lookup is a binary search
+/// instead of a comparison against every name.
+template <typename E>
+struct EnumTable {
+    using Entry = std::pair<E, std::string_view>;
+
+    static constexpr auto K_SORTED = [] {
+        auto entries = magic_enum::enum_entries<E>();
+        std::ranges::sort(entries, {}, &Entry::second);
+        return entries;
+    }();
+
+    static std::optional<E> find(std::string_view name) {
+        auto it = std::ranges::lower_bound(K_SORTED, name, {}, &Entry::second);
+        if (it == K_SORTED.end() || it->second != name || it->first == E::COUNT)
+            return std::nullopt;
+        return it->first;
+    }
+};
+
+/// @brief Space-separated fields of one line, as views into the mapped file.
+class Fields {
+public:
+    explicit Fields(std::string_view line) : m_rest(line) {}
+
+    /// @brief Empty once the line is used up.
+    std::string_view next() {
+        skipSpaces();
+        size_t end = std::min(m_rest.find_first_of(" \t\r"), m_rest.size());
+        auto field = m_rest.substr(0, end);
+        m_rest.remove_prefix(end);
+        return field;
+    }
+
+    /// @brief Everything left, trimmed, e.g. a free-form string.
+    std::string_view rest() {
+        skipSpaces();
+        auto end = m_rest.find_last_not_of(" \t\r");
+        auto field = end == std::string_view::npos ? std::string_view() : m_rest.substr(0, end + 1);
+        m_rest = {};
+        return field;
+    }
+
+private:
+    std::string_view m_rest;
+
+    void skipSpaces() {
+        m_rest.remove_prefix(std::min(m_rest.find_first_not_of(" \t\r"), m_rest.size()));
+    }
+};
+
+/// @brief The whole field must be a number, so "3.0x" is an error rather than 3.
+template <typename T>
+bool parseNumber(std::string_view field, T& out) {
+    auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), out);
+    return ec == std::errc() && ptr == field.data() + field.size() && !field.empty();
+}
+
+/// @brief Optional trailing number: keeps `out` when the field is missing.
+template <typename T>
+bool parseOptional(std::string_view field, T& out) {
+    return field.empty() || parseNumber(field, out);
+}
+
+std::shared_ptr<Device> makeDevice(DeviceKind kind, Fields& fields) {
+    switch (kind) {
+    case DeviceKind::eDevice:
+    case DeviceKind::eDemoDevice: {
+        auto name = fields.next();
+        if (name.empty())
+            return nullptr;
+        if (kind == DeviceKind::eDevice)
+            return std::make_shared<Device>(std::string(name));
+        return std::make_shared<DemoDevice>(std::string(name));
+    }
+    case DeviceKind::eAirFryer: {
+        float volume = 0.f;
+        if (!parseNumber(fields.next(), volume))
+            return nullptr;
+        return std::make_shared<AirFryer>(volume);
+    }
+    case DeviceKind::eWasherDryer: {
+        float volume = 0.f;
+        size_t bin_capacity = WasherDryer::K_DEFAULT_BIN_CAPACITY;
+        if (!parseNumber(fields.next(), volume) || !parseOptional(fields.next(), bin_capacity))
+            return nullptr;
+        return std::make_shared<WasherDryer>(volume, bin_capacity);
+    }
+    case DeviceKind::eRealAC: {
+        uint32_t power = 0;
+        if (!parseNumber(fields.next(), power))
+            return nullptr;
+        return std::make_shared<RealAC>(power);
+    }
+    default:
+        return nullptr;
+    }
+}
+
+/// @brief Feeds `SmartManager` one device at a time: its commands are collected while its lines
+/// are parsed and handed over together when the next device starts.
+class Loader {
+public:
+    explicit Loader(SmartManager& manager) : m_manager(manager) {}
+
+    void parseLine(std::string_view line, size_t line_no) {
+        line = line.substr(0, line.find('#'));
+        Fields fields(line);
+        auto keyword = fields.next();
+        bool ok = true;
+        if (keyword.empty())
+            return;
+        else if (keyword == "cmd")
+            ok = parseCommand(fields);
+        else if (keyword == "nop")
+            ok = addCommand(nullptr);
+        else if (keyword == "travel")
+            ok = parseTravel(fields);
+        else if (keyword == "device")
+            ok = parseDevice(fields);
+        else
+            ok = false;
+
+        if (!ok) {
+            Log::error("Config line {} skipped: {}", line_no, line);
+            m_stats.errors++;
+        }
+    }
+
+    Config::LoadStats finish() {
+        flush();
+        return m_stats;
+    }
+
+private:
+    SmartManager& m_manager;
+    Config::LoadStats m_stats;
+    /// @brief Device the following lines belong to, std::nullopt before the first one.
+    std::optional<DeviceId> m_device;
+    DataList m_commands;
+
+    bool parseDevice(Fields& fields) {
+        flush();
+        m_device.reset();
+        auto kind = EnumTable<DeviceKind>::find(fields.next());
+        auto device = kind ? makeDevice(*kind, fields) : nullptr;
+        if (device == nullptr)
+            return false;
+        m_device = m_manager.addDevice(std::move(device));
+        if (!m_device)
+            return false;
+        m_stats.devices++;
+        return true;
+    }
+
+    bool parseCommand(Fields& fields) {
+        auto op_id = EnumTable<DeviceOpId>::find(fields.next());
+        if (!op_id)
+            return false;
+        auto data = m_manager.createData();
+        data->op_id = *op_id;
+        data->mf_id = DeviceMfId::eNormal;
+        data->dfloat = 0.f;
+        data->dint = 0;
+        int dbool = 0;
+        if (auto mf = fields.next(); !mf.empty()) {
+            auto mf_id = EnumTable<DeviceMfId>::find(mf);
+            if (!mf_id)
+                return false;
+            data->mf_id = *mf_id;
+        }
+        if (!parseOptional(fields.next(), data->dfloat) ||
+            !parseOptional(fields.next(), data->dint) || !parseOptional(fields.next(), dbool))
+            return false;
+        data->dbool = dbool != 0;
+        data->dstring = fields.rest();
+        // Rejected here rather than in `flush()`, so only this line is skipped.
+        if (m_device && !m_manager.accepts(*m_device, *data))
+            return false;
+        return addCommand(std::move(data));
+    }
+
+    bool parseTravel(Fields& fields) {
+        uint32_t minutes = 0;
+        return m_device && parseNumber(fields.next(), minutes) &&
+               m_manager.addTravleTime(*m_device, std::move(minutes));
+    }
+
+    bool addCommand(std::shared_ptr<DeviceData>&& data) {
+        if (!m_device)
+            return false;
+        m_commands.push_back(std::move(data));
+        return true;
+    }
+
+    /// @brief Hand the current device's commands over in one call.
+    void flush() {
+        if (!m_device || m_commands.empty())
+            return;
+        size_t count = m_commands.size();
+        if (m_manager.addMultipleData(*m_device, std::move(m_commands)))
+            m_stats.commands += count;
+        else
+            m_stats.errors++;
+        m_commands.clear();
+    }
+};
+
+} // namespace
+
+namespace Config {
+
+LoadStats load(std::string_view text, SmartManager& manager) {
+    Loader loader(manager);
+    size_t line_no = 1;
+    while (!text.empty()) {
+        const auto* newline = static_cast<const char*>(std::memchr(text.data(), '\n', text.size()));
+        size_t length =
+            newline != nullptr ? static_cast<size_t>(newline - text.data()) : text.size();
+        loader.parseLine(text.substr(0, length), line_no++);
+        text.remove_prefix(std::min(length + 1, text.size()));
+    }
+    return loader.finish();
+}
+
+std::optional<LoadStats> loadFile(const std::string& path, SmartManager& manager) {
+    MappedFile file(path);
+    if (!file.isOpen())
+        return std::nullopt;
+    return load(file.getText(), manager);
+}
+
+} // namespace Config
@@ -0,0 +1,48 @@
+#include "data_pool.hpp"
+
+void* DataPool::allocate() {
+    std::lock_guard lock(m_mutex);
+    m_live++;
+    if (m_free != nullptr) {
+        Block* block = m_free;
+        m_free = block->next;
+        return block;
+    }
+
+    if (m_bump == K_BLOCKS_PER_SLAB) {
+        m_slab++;
+        m_bump = 0;
+    }
+    // Slabs left over from before a reset() are reused before growing.
+    if (m_slab == m_slabs.size())
+        m_slabs.push_back(std::make_unique<Block[]>(K_BLOCKS_PER_SLAB));
+    return &m_slabs[m_slab][m_bump++];
+}
+
+void DataPool::deallocate(void* p) {
+    auto* block = static_cast<Block*>(p);
+    std::lock_guard lock(m_mutex);
+    block->next = m_free;
+    m_free = block;
+    m_live--;
+}
+
+bool DataPool::reset() {
+    std::lock_guard lock(m_mutex);
+    if (m_live != 0)
+        return false;
+    m_free = nullptr;
+    m_slab = 0;
+    m_bump = 0;
+    return true;
+}
+
+size_t DataPool::getLiveCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_live;
+}
+
+size_t DataPool::getSlabCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_slabs.size();
+}
@@ -1,37 +1,118 @@
 // Placeholder content
 
 #include "device.hpp"
+#include "checkpoint.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <format>
-#include <iostream>
+#include <utility>
+
+void Device::logOperation(const DeviceData* data) const {
+    if (data == nullptr) {
+        Log::info("Empty log: I have done nothing!");
+        return;
+    }
+
+    std::string text;
+    for (const auto& record : m_records) {
+        if (record.cmd_id == data->cmd_id)
+            appendRecordText(text, record, OpStringTable::global());
+    }
+    Log::info("{} log: {}", magic_enum::enum_name(data->op_id), text);
+}
+
+void Device::recordOperation(const DeviceData* data) {
+    if (data == nullptr) {
+        m_records.push_back({.device_id = m_id, .event = OpEvent::eEmptyLog});
+        return;
+    }
+    emit(*data, OpEvent::eCommand);
+}
+
+void Device::recordSession() {
+    auto& record = m_records.emplace_back();
+    record.setTime(SimClock::now());
+    record.device_id = m_id;
+    record.str_id = m_name_id;
+    record.event = OpEvent::eSession;
+}
+
+OpRecord& Device::emit(const DeviceData& data, OpEvent event, SimClock::time_point time) {
+    return emit(data.cmd_id, data.op_id, data.mf_id, event, time);
+}
+
+OpRecord& Device::emit(
+    uint32_t cmd_id, DeviceOpId op_id, DeviceMfId mf_id, OpEvent event, SimClock::time_point time
+) {
+    auto& record = m_records.emplace_back();
+    record.setTime(time);
+    record.device_id = m_id;
+    record.cmd_id = cmd_id;
+    record.event = event;
+    record.op_id = static_cast<uint8_t>(op_id);
+    record.mf_id = static_cast<uint8_t>(mf_id);
+    return record;
+}
+
+void Device::afterTravel(EventEngine::Action then) {
+    if (m_travels == 0)
+        then();
+    else
+        m_after_travel = std::move(then);
+}
+
+void Device::travelFor(SimClock::duration d, EventEngine::Action then) {
+    // Nothing to wait for: stay in the current event, so an instant session isn't split.
+    if (s_engine == nullptr || d <= SimClock::duration::zero()) {
+        SimClock::sleepFor(d);
+        then();
+        return;
+    }
+    m_travels++;
+    s_engine->scheduleAfter(d, [this, then = std::move(then)] {
+        then();
+        // `then` may have traveled further, which keeps the count up.
+        if (--m_travels == 0 && m_after_travel)
+            std::exchange(m_after_travel, nullptr)();
+    });
+}
+
+void Device::wakeAt(SimClock::time_point at) {
+    if (s_engine != nullptr)
+        s_engine->schedule(at, [this] { wake(); });
+}
+
+void Device::saveState(Checkpoint::Writer& out) const {
+    out.putString(m_name);
+    out.put(m_id);
+    out.put(m_on);
+}
+
+bool Device::loadState(Checkpoint::Reader& in) {
+    if (!in.getString(m_name) || !in.get(m_id) || !in.get(m_on))
+        return false;
+    m_name_id = OpStringTable::global().intern(m_name);
+    s_global_id = std::max(s_global_id, m_id + 1);
+    return true;
+}
 
 void Device::hackName(std::string newName, size_t len) {
     // Hack the name from the beginning
     m_name.replace(0, len, newName);
-    std::cerr << "I got hacked and become " << getName() << std::endl;
+    m_name_id = OpStringTable::global().intern(m_name);
+    Log::warn("I got hacked and become {}", getName());
 }
 
-void DemoDevice::operate(std::shared_ptr<DeviceData> data) {
+void DemoDevice::operate(DeviceData* data) {
+    static_assert(Capability::handlesOnlyAccepted(K_OP_TABLE, DeviceKind::eDemoDevice));
     if (data == nullptr || !m_on)
         return;
 
-    switch (data->op_id) {
-    case DeviceOpId::eHello:
-        data->dstring = hello();
-        break;
-    case DeviceOpId::eSing:
-        data->dstring = sing();
-        break;
-    default:
-        // DeviceOpId::eDefault
-        Device::operate();
-        break;
-    }
-    return;
+    dispatch(K_OP_TABLE, data);
 }
 
-void DemoDevice::malfunction(std::shared_ptr<DeviceData> data) {
+void DemoDevice::malfunction(DeviceData* data) {
     if (data == nullptr || !m_on)
         return;
 
@@ -44,7 +125,7 @@ void DemoDevice::malfunction(std::shared_ptr<DeviceData> data) {
         hackName("Evil", 4);
         break;
     case DeviceMfId::eBroken:
-        std::cerr << getName() << " is broken!" << std::endl;
+        Log::error("{} is broken!", getName());
         break;
     default:
         // eNormal
@@ -53,11 +134,9 @@ void DemoDevice::malfunction(std::shared_ptr<DeviceData> data) {
     }
 }
 
-std::string DemoDevice::hello() const {
-    // std::format doesn't accept high_resolution_clock as it's not intended for display
-    return std::format(
-        "Hello World! This is device {}, greeting at {}!", getName(), getCurrentTime()
-    );
+void DemoDevice::hello(DeviceData* data) {
+    // "Hello World! This is device <name>, greeting at <time>!"
+    emit(*data, OpEvent::eHello).str_id = m_name_id;
 }
 
-std::string DemoDevice::sing() const { return "哈吉米, 哈吉米, 哈吉米, 哈吉米南北绿豆！"; }
+void DemoDevice::sing(DeviceData* data) { emit(*data, OpEvent::eSing); }
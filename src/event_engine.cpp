@@ -0,0 +1,20 @@
+#include "event_engine.hpp"
+
+void EventEngine::schedule(SimClock::time_point at, Action action) {
+    m_queue.push({at, m_next_seq++, std::move(action)});
+}
+
+size_t EventEngine::run() {
+    size_t count = 0;
+    m_stopped = false;
+    while (!m_stopped && !m_queue.empty()) {
+        // top() is const, but we pop right away so stealing the action is safe.
+        auto event = std::move(const_cast<Event&>(m_queue.top()));
+        m_queue.pop();
+
+        SimClock::advanceTo(event.at);
+        event.action();
+        count++;
+    }
+    return count;
+}
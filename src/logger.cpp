@@ -0,0 +1,227 @@
+#include "logger.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Entry {
+    LogLevel level;
+    std::string text;
+};
+
+/// @brief Bounded single-producer single-consumer ring owned by one logging thread.
+/// The producer only moves `m_head`, the consumer only moves `m_tail`.
+class ThreadBuffer {
+public:
+    static constexpr size_t K_CAPACITY = 1024;
+
+    bool tryPush(Entry& entry) {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == K_CAPACITY)
+            return false;
+        m_slots[head % K_CAPACITY] = std::move(entry);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Hand every published entry to `sink`. Only one consumer may drain at a time, which
+    /// `m_consuming` enforces between the flusher and a crash handler.
+    template <typename Sink>
+    void drain(Sink&& sink) {
+        if (m_consuming.test_and_set(std::memory_order_acquire))
+            return;
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        auto head = m_head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            sink(m_slots[tail % K_CAPACITY]);
+        }
+        m_tail.store(tail, std::memory_order_release);
+        m_consuming.clear(std::memory_order_release);
+    }
+
+    bool empty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    /// @brief Cleared when the owning thread exits; the flusher then drops the buffer once empty.
+    std::atomic<bool> alive = true;
+
+private:
+    std::array<Entry, K_CAPACITY> m_slots;
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+    std::atomic_flag m_consuming = ATOMIC_FLAG_INIT;
+};
+
+class AsyncLogger {
+public:
+    static AsyncLogger& instance() {
+        static AsyncLogger logger;
+        return logger;
+    }
+
+    void write(LogLevel level, std::string&& line) {
+        line.push_back('\n');
+        Entry entry = {level, std::move(line)};
+        auto& buffer = localBuffer();
+        while (!buffer.tryPush(entry)) {
+            // Back-pressure: wake the flusher and let it make room.
+            m_wake_cv.notify_one();
+            std::this_thread::yield();
+        }
+    }
+
+    void flush() {
+        std::lock_guard lock(m_write_mutex);
+        drainAll();
+    }
+
+    void setOutput(std::FILE* out, std::FILE* err) {
+        std::lock_guard lock(m_write_mutex);
+        drainAll();
+        m_out = out;
+        m_err = err;
+    }
+
+    /// @brief Best effort from a signal handler: don't wait on locks a crashed thread may hold.
+    void crashFlush() {
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        if (m_registry_mutex.try_lock()) {
+            buffers = m_buffers;
+            m_registry_mutex.unlock();
+        }
+        for (auto& buffer : buffers) {
+            buffer->drain([this](Entry& entry) {
+                std::fwrite(entry.text.data(), 1, entry.text.size(), streamOf(entry.level));
+            });
+        }
+        std::fflush(m_out);
+        std::fflush(m_err);
+    }
+
+private:
+    AsyncLogger() {
+        installCrashHandlers();
+        m_flusher = std::thread([this] { flusherLoop(); });
+    }
+
+    ~AsyncLogger() {
+        {
+            std::lock_guard lock(m_wake_mutex);
+            m_stop = true;
+        }
+        m_wake_cv.notify_one();
+        m_flusher.join();
+        flush();
+    }
+
+    std::FILE* m_out = stdout;
+    std::FILE* m_err = stderr;
+
+    std::mutex m_registry_mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+
+    /// @brief Serializes draining and writing; producers never take it.
+    std::mutex m_write_mutex;
+    std::string m_chunk;
+
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake_cv;
+    bool m_stop = false;
+    std::thread m_flusher;
+
+    std::FILE* streamOf(LogLevel level) const { return level >= LogLevel::eWarn ? m_err : m_out; }
+
+    /// @brief Registers this thread's buffer on first use and retires it when the thread exits.
+    ThreadBuffer& localBuffer() {
+        struct Owner {
+            std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+            Owner(AsyncLogger& logger) {
+                std::lock_guard lock(logger.m_registry_mutex);
+                logger.m_buffers.push_back(buffer);
+            }
+            ~Owner() { buffer->alive = false; }
+        };
+        thread_local Owner owner(*this);
+        return *owner.buffer;
+    }
+
+    /// @brief Caller holds `m_write_mutex`. Consecutive lines for the same stream are written
+    /// with a single fwrite, and a stream switch flushes so stdout and stderr stay in order.
+    void drainAll() {
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        {
+            std::lock_guard lock(m_registry_mutex);
+            std::erase_if(m_buffers, [](const auto& b) { return !b->alive && b->empty(); });
+            buffers = m_buffers;
+        }
+
+        std::FILE* stream = m_out;
+        auto writeChunk = [this, &stream] {
+            if (!m_chunk.empty())
+                std::fwrite(m_chunk.data(), 1, m_chunk.size(), stream);
+            m_chunk.clear();
+        };
+        for (auto& buffer : buffers) {
+            buffer->drain([&](Entry& entry) {
+                if (auto* target = streamOf(entry.level); target != stream) {
+                    writeChunk();
+                    std::fflush(stream);
+                    stream = target;
+                }
+                m_chunk += entry.text;
+            });
+        }
+        writeChunk();
+        std::fflush(m_out);
+        std::fflush(m_err);
+    }
+
+    void flusherLoop() {
+        using namespace std::chrono_literals;
+        std::unique_lock lock(m_wake_mutex);
+        while (!m_stop) {
+            m_wake_cv.wait_for(lock, 10ms);
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    static void installCrashHandlers() {
+        for (int sig : {SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS}) {
+            std::signal(sig, [](int signal) {
+                AsyncLogger::instance().crashFlush();
+                std::signal(signal, SIG_DFL);
+                std::raise(signal);
+            });
+        }
+        static std::terminate_handler previous = std::set_terminate([] {
+            AsyncLogger::instance().crashFlush();
+            if (previous)
+                previous();
+            std::abort();
+        });
+    }
+};
+
+} // namespace
+
+namespace Log {
+
+void write(LogLevel level, std::string line) { AsyncLogger::instance().write(level, std::move(line)); }
+
+void flush() { AsyncLogger::instance().flush(); }
+
+void setOutput(std::FILE* out, std::FILE* err) { AsyncLogger::instance().setOutput(out, err); }
+
+} // namespace Log
@@ -1,4 +1,5 @@
 #include "air_fryer.hpp"
+#include "config_loader.hpp"
 #include "device.hpp"
 #include "smart_manager.hpp"
 #include "washer_dryer.hpp"
@@ -11,6 +12,23 @@
 #include <vector>
 
 static constexpr bool SHOULD_DEMO = false;
+/// @brief Simulated seconds per real second. `K_MINUTE_PER_SEC` for a real-time demo, or run on the
+/// virtual clock so waiting for devices costs no wall time.
+static constexpr double TIME_SCALE = TimeScale::K_AS_FAST_AS_POSSIBLE;
+/// @brief Worker threads for `SmartManager::operate()`, 1 for serial.
+static constexpr size_t NUM_WORKERS = 4;
+/// @brief Non-empty: write a binary operation log there instead of text, decode it offline with
+/// `SmartHomeLogDecode`.
+static constexpr const char* OP_LOG_PATH = "";
+/// @brief Non-empty: load devices and commands from this file, e.g. "config/smart_home.cfg",
+/// instead of the hard-coded `populate*()` below. See `Config` for the format.
+static constexpr const char* CONFIG_PATH = "";
+/// @brief Non-empty: record every device and command fed to the manager there, to reproduce the
+/// run later with `REPLAY_PATH`. See `SmartManager::startRecording()`.
+static constexpr const char* RECORD_PATH = "";
+/// @brief Non-empty: replay this recording instead of building the home, e.g. to debug an
+/// incident. Its log matches the recorded run byte for byte.
+static constexpr const char* REPLAY_PATH = "";
 static constexpr size_t N = 10;
 static constexpr float ROOM_TEMP = 25.f;
 typedef std::vector<std::vector<std::shared_ptr<DeviceData>>> NestedDeviceData;
@@ -33,13 +51,16 @@ static void populateDevices(std::vector<std::shared_ptr<Device>>& vec) {
     vec.push_back(std::make_shared<RealAC>(2000 /* power in watt */));
 }
 
+/// @brief Travel times are in simulated minutes, like every other device duration.
 static void populateTravelTimes(std::vector<uint32_t>& vec) {
-    // no override for Device, DemoDevice, or AirFryer, so 0 is no_op.
+    // no override for Device or DemoDevice, so 0 is no_op.
     vec.push_back(0);
     vec.push_back(0);
+    // For AirFryer, 0 is cook till the basket is empty.
     vec.push_back(0);
 
-    vec.push_back(10);
+    // WasherDryer jobs queue: wash 0-5, combo wash 5-12, combo dry 12-19.
+    vec.push_back(20);
 
     // For RealAC, 0 is sim to end.
     vec.push_back(0);
@@ -48,14 +69,16 @@ static void populateTravelTimes(std::vector<uint32_t>& vec) {
 /// @brief TEMP: hard-code creation of device operation data.
 /// In reality, each data should be created on-the-fly by `SmartManager`.
 /// @param vec Empty vector of DeviceData shared_ptr to be populated.
-static void populateData(NestedDeviceData& vec) {
+/// @param make_data Creates one empty `DeviceData`, e.g. `SmartManager::createData()`.
+template <std::invocable MakeData>
+static void populateData(NestedDeviceData& vec, MakeData&& make_data) {
     if (!vec.empty())
         vec.clear();
 
     // For device
     {
         std::vector<std::shared_ptr<DeviceData>> vdata;
-        auto data0a = std::make_shared<DeviceData>();
+        auto data0a = make_data();
         auto data0b = nullptr;
         vdata.push_back(data0a);
         vdata.push_back(data0b);
@@ -67,13 +90,13 @@ static void populateData(NestedDeviceData& vec) {
     {
         std::vector<std::shared_ptr<DeviceData>> vdata;
         {
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eHello;
             data->mf_id = DeviceMfId::eBroken;
             vdata.push_back(data);
         }
         {
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eSing;
             data->mf_id = DeviceMfId::eNormal;
             vdata.push_back(data);
@@ -81,11 +104,11 @@ static void populateData(NestedDeviceData& vec) {
         vec.push_back(vdata);
     }
 
-    // For AirFryer, int and float are time and volume of food to cook
+    // For AirFryer, int and float are time (minutes) and volume of food to cook
     {
         std::vector<std::shared_ptr<DeviceData>> vdata;
         {
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eAirFryerCook;
             data->mf_id = DeviceMfId::eNormal;
             data->dint = 5;
@@ -93,7 +116,7 @@ static void populateData(NestedDeviceData& vec) {
             vdata.push_back(data);
         }
         {
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eAirFryerClean;
             data->mf_id = DeviceMfId::eLowBattery;
             vdata.push_back(data);
@@ -101,11 +124,11 @@ static void populateData(NestedDeviceData& vec) {
         vec.push_back(vdata);
     }
 
-    // For WahserDryer, int and float are time and volume of cloth
+    // For WahserDryer, int and float are time (minutes) and volume of cloth
     {
         std::vector<std::shared_ptr<DeviceData>> vdata;
         {
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eWashDryerDryOnly;
             data->mf_id = DeviceMfId::eNormal;
             data->dint = 3;
@@ -113,7 +136,7 @@ static void populateData(NestedDeviceData& vec) {
             vdata.push_back(data);
         }
         {
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eWashDryerWashOnly;
             data->mf_id = DeviceMfId::eNormal;
             data->dint = 5;
@@ -121,7 +144,7 @@ static void populateData(NestedDeviceData& vec) {
             vdata.push_back(data);
         }
         {
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eWashDryerCombo;
             data->mf_id = DeviceMfId::eHacked;
             data->dint = 7;
@@ -131,13 +154,13 @@ static void populateData(NestedDeviceData& vec) {
         vec.push_back(vdata);
     }
 
-    // For RealAC, float, int, bool, string are target temperature, duration (mins but actually
-    // executed in secs), heat or not, mode.
+    // For RealAC, float, int, bool, string are target temperature, duration in minutes, heat or
+    // not, mode.
     {
         std::vector<std::shared_ptr<DeviceData>> vdata;
         {
             // 2000w in low is 500w, +3 degree needs 10 mins
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eRealAcOpenTillDeg;
             data->mf_id = DeviceMfId::eNormal;
             // data->dint = 10;
@@ -148,7 +171,7 @@ static void populateData(NestedDeviceData& vec) {
         }
         {
             // 2000w in mid is 1000w, for 5 mins, expect -= 3 degree
-            auto data = std::make_shared<DeviceData>();
+            auto data = make_data();
             data->op_id = DeviceOpId::eRealAcOpenForMins;
             data->mf_id = DeviceMfId::eNormal;
             data->dint = 5;
@@ -213,8 +236,8 @@ static void demo() {
         data->dint = static_cast<int>(index); // seconds
         data->dfloat = static_cast<float>(index) + 0.1f;
 
-        device->operate(data);
-        device->malfunction(data);
+        device->operate(data.get());
+        device->malfunction(data.get());
         std::cout << std::string(20, '=') << std::endl;
     }
 
@@ -228,7 +251,7 @@ static void demo() {
 #endif
 
     NestedDeviceData all_data;
-    populateData(all_data);
+    populateData(all_data, [] { return std::make_shared<DeviceData>(); });
     std::vector<uint32_t> travel_times;
     populateTravelTimes(travel_times);
     for (const auto& [device, vdata, ttime] : zip_view::zip(vec_devices, all_data, travel_times)) {
@@ -236,9 +259,9 @@ static void demo() {
                   << std::format("{} at {}", device->getName(), device->getCurrentTime())
                   << std::string(20, '=') << std::endl;
         // Operate
-        for (const auto d : vdata) {
-            device->operate(d);
-            device->malfunction(d);
+        for (const auto& d : vdata) {
+            device->operate(d.get());
+            device->malfunction(d.get());
         }
         device->timeTravel(ttime);
         /// Here we only demo how pointer cast works. The best practice is NOT to:
@@ -249,26 +272,19 @@ static void demo() {
         }
 
         // Then Log
-        for (const auto d : vdata) {
-            device->logOperation(d);
+        for (const auto& d : vdata) {
+            device->logOperation(d.get());
         }
     }
 }
 
-int main() {
-    if (SHOULD_DEMO)
-        demo();
-
-    // Create SmartManager and connect Room to it
-    std::shared_ptr<Room> sp_room = std::make_shared<Room>(ROOM_TEMP);
-    std::shared_ptr<SmartManager> sp_manager = std::make_shared<SmartManager>();
-    sp_manager->connectToRoom(std::move(sp_room));
-
+/// @brief Hand the hard-coded devices, commands and travel times to `manager`.
+static void populateManager(SmartManager& manager) {
     // prepare data
     std::vector<std::shared_ptr<Device>> vec_devices;
     populateDevices(vec_devices);
     NestedDeviceData all_data;
-    populateData(all_data);
+    populateData(all_data, [&manager] { return manager.createData(); });
     std::vector<uint32_t> travel_times;
     populateTravelTimes(travel_times);
 
@@ -282,17 +298,55 @@ int main() {
 #endif
 
     for (const auto& [device, vdata, ttime] : zip_view::zip(vec_devices, all_data, travel_times)) {
-        auto name = device->getName();
-
-        sp_manager->addDevice(std::move(device));
-        sp_manager->addMultipleData(name, std::move(vdata));
-        sp_manager->addTravleTime(name, std::move(ttime));
+        if (auto id = manager.addDevice(std::move(device))) {
+            manager.addMultipleData(*id, std::move(vdata));
+            manager.addTravleTime(*id, std::move(ttime));
+        }
 
         Debug::logAssert(device == nullptr, "device == nullptr");
         Debug::logAssert(vdata.size() == 0, "vdata.size() == 0");
     }
+}
+
+int main() {
+    if (SHOULD_DEMO)
+        demo();
+
+    // Create SmartManager and connect Room to it
+    std::shared_ptr<Room> sp_room = std::make_shared<Room>(ROOM_TEMP);
+    std::shared_ptr<SmartManager> sp_manager = std::make_shared<SmartManager>();
+    sp_manager->connectToRoom(std::move(sp_room));
+    sp_manager->setTimeScale(TIME_SCALE);
+    sp_manager->setParallel(NUM_WORKERS);
+    if (*OP_LOG_PATH != '\0' && !sp_manager->setOpLog(OP_LOG_PATH))
+        Log::error("Cannot open operation log {}", OP_LOG_PATH);
+
+    if (*REPLAY_PATH != '\0') {
+        if (!sp_manager->replay(REPLAY_PATH))
+            Log::error("Replay of {} failed", REPLAY_PATH);
+        sp_manager->closeOpLog();
+        return 0;
+    }
+    if (*RECORD_PATH != '\0' && !sp_manager->startRecording(RECORD_PATH))
+        Log::error("Cannot record to {}", RECORD_PATH);
+
+    if (*CONFIG_PATH == '\0') {
+        populateManager(*sp_manager);
+    } else if (auto stats = Config::loadFile(CONFIG_PATH, *sp_manager)) {
+        Log::info(
+            "Loaded {} devices and {} commands from {}, {} errors",
+            stats->devices,
+            stats->commands,
+            CONFIG_PATH,
+            stats->errors
+        );
+    } else {
+        Log::error("Cannot open config {}", CONFIG_PATH);
+    }
 
     sp_manager->operate();
+    sp_manager->stopRecording();
+    sp_manager->closeOpLog();
 
     return 0;
 }
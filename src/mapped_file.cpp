@@ -0,0 +1,45 @@
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        m_size = static_cast<size_t>(info.st_size);
+        void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, m_size, MADV_SEQUENTIAL);
+            m_map = static_cast<const char*>(addr);
+        }
+    }
+    ::close(fd);
+    if (m_map != nullptr || m_size == 0) {
+        m_ok = true;
+        return;
+    }
+#endif
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return;
+    m_fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_ok = true;
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+    if (m_map != nullptr)
+        ::munmap(const_cast<char*>(m_map), m_size);
+#endif
+}
@@ -0,0 +1,276 @@
+#include "op_log.hpp"
+
+#include <cstring>
+#include <format>
+
+OpStringTable& OpStringTable::global() {
+    static OpStringTable table;
+    return table;
+}
+
+uint32_t OpStringTable::intern(std::string_view str) {
+    std::lock_guard lock(m_mutex);
+    if (auto it = m_ids.find(str); it != m_ids.end())
+        return it->second;
+    auto id = static_cast<uint32_t>(m_strings.size());
+    const auto& stored = m_strings.emplace_back(str);
+    m_ids.emplace(stored, id);
+    return id;
+}
+
+std::string_view OpStringTable::lookup(uint32_t id) const {
+    std::lock_guard lock(m_mutex);
+    return id < m_strings.size() ? std::string_view(m_strings[id]) : std::string_view();
+}
+
+size_t OpStringTable::size() const {
+    std::lock_guard lock(m_mutex);
+    return m_strings.size();
+}
+
+void appendRecordText(std::string& out, const OpRecord& record, const OpStringTable& strings) {
+    auto time = formatClockTime<SimClock>(record.getTime());
+    auto it = std::back_inserter(out);
+
+    switch (record.event) {
+    case OpEvent::eHello:
+        std::format_to(
+            it,
+            "Hello World! This is device {}, greeting at {}!",
+            strings.lookup(record.str_id),
+            time
+        );
+        break;
+    case OpEvent::eSing:
+        out += "哈吉米, 哈吉米, 哈吉米, 哈吉米南北绿豆！";
+        break;
+    case OpEvent::eCookTooBig:
+        std::format_to(
+            it,
+            "Food volume {} bigger than total volume {}. Buy a bigger one!",
+            record.f0,
+            record.f1
+        );
+        break;
+    case OpEvent::eCookNoSpace:
+        std::format_to(
+            it,
+            "Food volume {} bigger than current volume {}. Wait for more space.",
+            record.f0,
+            record.f1
+        );
+        break;
+    case OpEvent::eCookQueued:
+        std::format_to(
+            it,
+            "Food volume {} fits current volume {}, but queued behind {} pending requests.",
+            record.f0,
+            record.f1,
+            record.i0
+        );
+        break;
+    case OpEvent::eCookDone:
+        std::format_to(it, "completes cooking after {} minutes at {}", record.i0, time);
+        break;
+    case OpEvent::eCleanupDone:
+        std::format_to(it, "cleanup done at {}", time);
+        break;
+    case OpEvent::eClothTooMuch:
+        std::format_to(
+            it, "You put too much cloth ({}) more than total volume {}.\n", record.f0, record.f1
+        );
+        break;
+    case OpEvent::eJobDone:
+        std::format_to(
+            it,
+            "{} job completes after {} minutes, at {}. ",
+            record.flag ? "Wash" : "Dry",
+            record.i0,
+            time
+        );
+        break;
+    case OpEvent::eComboHandoff:
+        std::format_to(it, "Begin dry in the combo, also take {} minutes; ", record.i0);
+        break;
+    case OpEvent::eComboWaits:
+        std::format_to(
+            it, "Dry bin is full with {} jobs, the combo waits in the washer; ", record.i0
+        );
+        break;
+    case OpEvent::eBinFull:
+        std::format_to(
+            it,
+            "{} bin is full with {} jobs, come back later.\n",
+            record.flag ? "Wash" : "Dry",
+            record.i0
+        );
+        break;
+    case OpEvent::eAcOpenTillDeg:
+        std::format_to(
+            it,
+            "openTillDeg() starts from {} at {}, set to {} on {}, targeting {} Celius degree",
+            record.f0,
+            time,
+            record.flag ? "heat" : "cool",
+            strings.lookup(record.str_id),
+            record.f1
+        );
+        break;
+    case OpEvent::eAcOpenForMins:
+        std::format_to(
+            it,
+            "openForMins() starts from {} at {}, set to {} on {}, should run for {} min",
+            record.f0,
+            time,
+            record.flag ? "heat" : "cool",
+            strings.lookup(record.str_id),
+            record.i0
+        );
+        break;
+    default:
+        // eSession, eCommand, eEmptyLog are framing, see renderOpLog()
+        break;
+    }
+}
+
+bool OpLogWriter::open(const std::string& path) {
+    close();
+    std::lock_guard lock(m_mutex);
+    m_file = std::fopen(path.c_str(), "wb");
+    if (m_file == nullptr)
+        return false;
+
+    uint32_t version = K_VERSION;
+    uint32_t record_size = sizeof(OpRecord);
+    std::fwrite(K_MAGIC, 1, sizeof(K_MAGIC), m_file);
+    std::fwrite(&version, sizeof(version), 1, m_file);
+    std::fwrite(&record_size, sizeof(record_size), 1, m_file);
+    return true;
+}
+
+void OpLogWriter::write(std::span<const OpRecord> records) {
+    std::lock_guard lock(m_mutex);
+    if (m_file != nullptr && !records.empty())
+        std::fwrite(records.data(), sizeof(OpRecord), records.size(), m_file);
+}
+
+void OpLogWriter::close() {
+    std::lock_guard lock(m_mutex);
+    if (m_file == nullptr)
+        return;
+
+    uint64_t table_offset = static_cast<uint64_t>(std::ftell(m_file));
+    const auto& strings = OpStringTable::global();
+    auto count = static_cast<uint32_t>(strings.size());
+    std::fwrite(&count, sizeof(count), 1, m_file);
+    for (uint32_t id = 0; id < count; id++) {
+        auto str = strings.lookup(id);
+        auto len = static_cast<uint32_t>(str.size());
+        std::fwrite(&len, sizeof(len), 1, m_file);
+        std::fwrite(str.data(), 1, len, m_file);
+    }
+    std::fwrite(&table_offset, sizeof(table_offset), 1, m_file);
+
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+bool readOpLog(const std::string& path, std::vector<OpRecord>& records, OpStringTable& strings) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    char magic[sizeof(OpLogWriter::K_MAGIC)];
+    uint32_t version = 0;
+    uint32_t record_size = 0;
+    uint64_t table_offset = 0;
+    constexpr long HEADER_SIZE = sizeof(magic) + sizeof(version) + sizeof(record_size);
+    bool ok = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+              std::memcmp(magic, OpLogWriter::K_MAGIC, sizeof(magic)) == 0 &&
+              std::fread(&version, sizeof(version), 1, file) == 1 &&
+              version == OpLogWriter::K_VERSION &&
+              std::fread(&record_size, sizeof(record_size), 1, file) == 1 &&
+              record_size == sizeof(OpRecord) && std::fseek(file, 0, SEEK_END) == 0;
+    long file_size = ok ? std::ftell(file) : 0;
+    ok = ok && file_size >= HEADER_SIZE + static_cast<long>(sizeof(table_offset)) &&
+         std::fseek(file, -static_cast<long>(sizeof(table_offset)), SEEK_END) == 0 &&
+         std::fread(&table_offset, sizeof(table_offset), 1, file) == 1;
+
+    // Whole records between the header and the table, and room for the table's count before the
+    // footer. Lengths read later are checked against what is left, so a corrupt one fails the
+    // read instead of allocating gigabytes first.
+    uint64_t table_end = static_cast<uint64_t>(file_size) - sizeof(table_offset);
+    ok = ok && table_offset >= HEADER_SIZE && table_offset <= table_end &&
+         table_end - table_offset >= sizeof(uint32_t) &&
+         (table_offset - HEADER_SIZE) % sizeof(OpRecord) == 0;
+    if (ok) {
+        // string table
+        ok = std::fseek(file, static_cast<long>(table_offset), SEEK_SET) == 0;
+        uint32_t count = 0;
+        ok = ok && std::fread(&count, sizeof(count), 1, file) == 1;
+        uint64_t left = table_end - table_offset - sizeof(count);
+        // Every string takes at least its length field.
+        ok = ok && count <= left / sizeof(uint32_t);
+        std::string str;
+        for (uint32_t id = 0; ok && id < count; id++) {
+            uint32_t len = 0;
+            ok = left >= sizeof(len) && std::fread(&len, sizeof(len), 1, file) == 1 &&
+                 len <= left - sizeof(len);
+            if (!ok)
+                break;
+            left -= sizeof(len) + len;
+            str.resize(len);
+            ok = std::fread(str.data(), 1, len, file) == len;
+            // ids must match the writer's, so intern in order into a fresh table
+            ok = ok && strings.intern(str) == id;
+        }
+        ok = ok && left == 0;
+    }
+    if (ok) {
+        // records
+        records.resize((table_offset - HEADER_SIZE) / sizeof(OpRecord));
+        ok = std::fseek(file, HEADER_SIZE, SEEK_SET) == 0 &&
+             std::fread(records.data(), sizeof(OpRecord), records.size(), file) == records.size();
+    }
+
+    std::fclose(file);
+    return ok;
+}
+
+std::string renderOpLog(std::span<const OpRecord> records, const OpStringTable& strings) {
+    std::string out;
+    /// (device_id, cmd_id) to text collected so far for that command
+    std::unordered_map<uint64_t, std::string> pending;
+    auto keyOf = [](const OpRecord& r) { return (uint64_t(r.device_id) << 32) | r.cmd_id; };
+
+    for (const auto& record : records) {
+        switch (record.event) {
+        case OpEvent::eSession:
+            std::format_to(
+                std::back_inserter(out),
+                "{0}{1} at {2}{0}\n",
+                std::string(20, '='),
+                strings.lookup(record.str_id),
+                formatClockTime<SimClock>(record.getTime())
+            );
+            break;
+        case OpEvent::eCommand: {
+            auto node = pending.extract(keyOf(record));
+            std::format_to(
+                std::back_inserter(out),
+                "{} log: {}\n",
+                magic_enum::enum_name(static_cast<DeviceOpId>(record.op_id)),
+                node.empty() ? std::string() : node.mapped()
+            );
+            break;
+        }
+        case OpEvent::eEmptyLog:
+            out += "Empty log: I have done nothing!\n";
+            break;
+        default:
+            appendRecordText(pending[keyOf(record)], record, strings);
+            break;
+        }
+    }
+    return out;
+}
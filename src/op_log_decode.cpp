@@ -0,0 +1,23 @@
+#include "op_log.hpp"
+
+#include <cstdio>
+
+/// @brief Offline pretty-printer: renders a binary operation log written by
+/// `SmartManager::setOpLog()` into the same text the live log prints.
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: %s <op_log.bin>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<OpRecord> records;
+    OpStringTable strings;
+    if (!readOpLog(argv[1], records, strings)) {
+        std::fprintf(stderr, "Cannot read operation log %s\n", argv[1]);
+        return 1;
+    }
+
+    auto text = renderOpLog(records, strings);
+    std::fwrite(text.data(), 1, text.size(), stdout);
+    return 0;
+}
@@ -1,7 +1,9 @@
 #include "real_ac.hpp"
+#include "checkpoint.hpp"
 #include "utils.hpp"
 
-void RealAC::operate(std::shared_ptr<DeviceData> data) {
+void RealAC::operate(DeviceData* data) {
+    static_assert(Capability::handlesOnlyAccepted(K_OP_TABLE, DeviceKind::eRealAC));
     if (data == nullptr || !m_on)
         return;
 
@@ -9,21 +11,10 @@ void RealAC::operate(std::shared_ptr<DeviceData> data) {
     Debug::logAssert(Device::s_room != nullptr, "Haven't logged room into {}", getName());
     // Check fields of `data` should happen in private worker functions.
 
-    switch (data->op_id) {
-    case DeviceOpId::eRealAcOpenTillDeg:
-        openTillDeg(data);
-        break;
-    case DeviceOpId::eRealAcOpenForMins:
-        openForMins(data);
-        break;
-    default:
-        Device::operate();
-        data->logOpId();
-        break;
-    }
+    dispatch(K_OP_TABLE, data);
 }
 
-void RealAC::malfunction(std::shared_ptr<DeviceData> data) {
+void RealAC::malfunction(DeviceData* data) {
     if (data == nullptr || !m_on)
         return;
 
@@ -32,7 +23,7 @@ void RealAC::malfunction(std::shared_ptr<DeviceData> data) {
         m_on = false;
         break;
     case DeviceMfId::eHacked: {
-        std::cerr << getName() << " gets hacked! Burning everyone to death!" << std::endl;
+        Log::warn("{} gets hacked! Burning everyone to death!", getName());
         // stop curr op and burn to 45 deg
         updateTemp();
         m_timer.stop();
@@ -43,7 +34,7 @@ void RealAC::malfunction(std::shared_ptr<DeviceData> data) {
         break;
     }
     case DeviceMfId::eBroken:
-        std::cerr << getName() << " is leaking! See if Super Mario can help!" << std::endl;
+        Log::error("{} is leaking! See if Super Mario can help!", getName());
         break;
     default:
         // eNormal
@@ -52,108 +43,148 @@ void RealAC::malfunction(std::shared_ptr<DeviceData> data) {
     }
 }
 
-uint32_t RealAC::timeTravel(const uint32_t duration_sec) {
-    uint32_t remaining_time =
-        duration_sec == 0 ? static_cast<uint32_t>(m_timer.checkRemainingTime()) : duration_sec;
-    std::this_thread::sleep_for(std::chrono::seconds(duration_sec));
-    updateTemp();
+uint32_t RealAC::timeTravel(const uint32_t duration_min) {
+    uint32_t remaining_time = duration_min == 0
+                                  ? static_cast<uint32_t>(m_timer.checkRemainingTime() / 60)
+                                  : duration_min;
+    travelFor(std::chrono::minutes(duration_min), [this] { updateTemp(); });
     return remaining_time;
 }
 
-void RealAC::openTillDeg(std::shared_ptr<DeviceData> data) {
-    // Step 0, store log
-    std::string log_str = std::format(
-        "openTillDeg() starts from {} at {}, set to {} on {}, targeting {} Celius degree",
-        s_room->getTemp(),
-        getCurrentTime(),
-        data->dbool ? "heat" : "cool",
-        data->dstring, // mode
-        data->dfloat
-    );
-    // Step 1, validate input; dfloat, dbool, dstring are target temp, heat or not, mode
+void RealAC::operateBatch(std::span<DeviceData* const> batch) {
+    size_t i = 0;
+    while (i < batch.size() && m_on) {
+        size_t run_end = i;
+        while (run_end < batch.size() && isMergeableOpen(batch[run_end])) {
+            run_end++;
+        }
+        // All but the last command of a run are overridden right away: log them only.
+        for (; i + 1 < run_end; i++) {
+            beginOpen(batch[i]);
+            RealAC::malfunction(batch[i]);
+        }
+        RealAC::operate(batch[i]);
+        RealAC::malfunction(batch[i]);
+        i++;
+    }
+}
+
+bool RealAC::isMergeableOpen(const DeviceData* data) {
+    return data != nullptr &&
+           (data->op_id == DeviceOpId::eRealAcOpenTillDeg ||
+            data->op_id == DeviceOpId::eRealAcOpenForMins) &&
+           (data->mf_id == DeviceMfId::eNormal || data->mf_id == DeviceMfId::eBroken);
+}
+
+void RealAC::beginOpen(DeviceData* data) {
     Debug::logAssert(data != nullptr, "caller Operate() should filter out nullptr input");
+    if (data->op_id == DeviceOpId::eRealAcOpenTillDeg) {
+        // Store log: starting temperature, heat or not, mode and target
+        auto& record = emit(*data, OpEvent::eAcOpenTillDeg);
+        record.f0 = s_room->getTemp();
+        record.f1 = data->dfloat;
+        record.flag = data->dbool;
+        record.str_id = OpStringTable::global().intern(data->dstring);
+        // Validate input; dfloat, dbool, dstring are target temp, heat or not, mode
+        Debug::logAssert(
+            (data->dfloat - s_room->getTemp()) > 0 == data->dbool, // heat/cool matches target
+            "RealAC::openTillDeg(), current temperature is {}, but you set {} target temp {}",
+            s_room->getTemp(),
+            data->dbool ? "heat" : "cool",
+            data->dfloat
+        );
+    } else {
+        // Store log: starting temperature, heat or not, mode and duration
+        auto& record = emit(*data, OpEvent::eAcOpenForMins);
+        record.f0 = s_room->getTemp();
+        record.i0 = data->dint;
+        record.flag = data->dbool;
+        record.str_id = OpStringTable::global().intern(data->dstring);
+        // Validate input; dint, dbool, dstring are duration, heat or not, mode
+        Debug::logAssert(
+            data->dint > 0,
+            "RealAC::openForMins(), duration minutes should be positive, got {}",
+            data->dint
+        );
+    }
+    // Mode is applied by the caller, but checked here so merged commands are validated too.
     Debug::logAssert(
-        (data->dfloat - s_room->getTemp()) > 0 == data->dbool, // heat/cool matches target
-        "RealAC::openTillDeg(), current temperature is {}, but you set {} target temp {}",
-        s_room->getTemp(),
-        data->dbool ? "heat" : "cool",
-        data->dfloat
+        magic_enum::enum_cast<Mode>(data->dstring).has_value(),
+        "RealAC, {} is NOT a AC power mode. Supported are eFull, eMid, and eLow.",
+        data->dstring
     );
 
-    // Step 2, finish previous AC session.
+    // Finish previous AC session.
     updateTemp();
     if (m_timer.running)
         m_timer.stop();
+    m_applied_sec = 0;
+}
+
+void RealAC::openTillDeg(DeviceData* data) {
+    // Step 0-2, log, validate and finish previous AC session
+    beginOpen(data);
 
     // Step 3, mode must be updated after updateTemp()
     bool set_mode_success = setMode(data->dstring);
     Debug::logAssert(set_mode_success, "RealAC::setMode() failed");
-    // and update log
-    data->dstring = log_str;
 
     // Step 4, set heat/cold, compute time, and launch new AC session
     m_heat = data->dbool;
-    // time = delta temp / (power * K_DEG_PER_JOULE)
+    // time = delta temp / (power * K_DEG_PER_JOULE); with no power at this mode it never gets there
     float delta_temp = std::abs(s_room->getTemp() - data->dfloat);
-    auto duration = static_cast<uint32_t>(delta_temp / (K_DEG_PER_JOULE * getPower()));
-    m_timer.begin(duration);
+    float rate = K_DEG_PER_JOULE * getPower();
+    auto duration = rate > 0.f ? static_cast<uint32_t>(delta_temp / rate) : 0u;
+    m_timer.begin(std::chrono::seconds(duration));
+    wakeAt(m_timer.t_start + m_timer.t_total_sec);
 }
 
-void RealAC::openForMins(std::shared_ptr<DeviceData> data) {
-    // Step 0, store log
-    std::string log_str = std::format(
-        "openForMins() starts from {} at {}, set to {} on {}, should run for {} sec",
-        s_room->getTemp(),
-        getCurrentTime(),
-        data->dbool ? "heat" : "cool",
-        data->dstring, // mode
-        data->dint
-    );
-
-    // Step 1, validate input; dint, dbool, dstring are duration, heat or not, mode
-    Debug::logAssert(data != nullptr, "caller Operate() should filter out nullptr input");
-    Debug::logAssert(
-        data->dint > 0,
-        "RealAC::openForMins(), duration minutes should be positive, got {}",
-        data->dint
-    );
-
-    // Step 2, finish previous AC session.
-    updateTemp();
-    if (m_timer.running)
-        m_timer.stop();
+void RealAC::openForMins(DeviceData* data) {
+    // Step 0-2, log, validate and finish previous AC session
+    beginOpen(data);
 
     // Step 3, mode must be updated after updateTemp()
     bool set_mode_success = setMode(data->dstring);
     Debug::logAssert(set_mode_success, "RealAC::setMode() failed");
-    // and update log
-    data->dstring = log_str;
 
     // Step 4, set heat/cool and launch new AC session
     m_heat = data->dbool;
-    m_timer.begin(data->dint);
+    m_timer.begin(std::chrono::minutes(data->dint));
+    wakeAt(m_timer.t_start + m_timer.t_total_sec);
 }
 
 void RealAC::updateTemp() {
     if (!m_timer.running)
         return;
 
-    // This is actual execution time, with each sec simulation 1 min set by user.
+    // Simulated execution time, independent of the time scale. Only the part not applied by an
+    // earlier call goes to the room, so partial time travels don't count twice.
     int op_time_sec = m_timer.t_total_sec.count() - m_timer.checkRemainingTime();
-    float new_temp =
-        s_room->getTemp() + (m_heat ? 1.0f : -1.0f) * K_DEG_PER_JOULE * getPower() * op_time_sec;
-    s_room->setTemp(new_temp);
+    int new_sec = op_time_sec - m_applied_sec;
+    m_applied_sec = op_time_sec;
+    s_room->addTemp((m_heat ? 1.0f : -1.0f) * K_DEG_PER_JOULE * getPower() * new_sec);
 }
 
 bool RealAC::setMode(std::string str) {
     // std::optional
     auto op_mode = magic_enum::enum_cast<Mode>(str);
     if (!op_mode.has_value()) {
-        std::cerr << std::format(
-            "{} is NOT a AC power mode. Supported are eFull, eMid, and eLow.\n", str
-        );
+        Log::error("{} is NOT a AC power mode. Supported are eFull, eMid, and eLow.", str);
         return false;
     }
     m_mode = op_mode.value();
     return true;
 }
+
+void RealAC::saveState(Checkpoint::Writer& out) const {
+    Device::saveState(out);
+    out.put(m_heat);
+    out.putTimer(m_timer);
+    out.put(m_applied_sec);
+    out.put(m_mode);
+}
+
+bool RealAC::loadState(Checkpoint::Reader& in) {
+    return Device::loadState(in) && in.get(m_heat) && in.getTimer(m_timer) &&
+           in.get(m_applied_sec) && in.getEnum(m_mode);
+}
@@ -1,79 +1,498 @@
 #include "smart_manager.hpp"
+#include "checkpoint.hpp"
+#include "mapped_file.hpp"
 
-bool SmartManager::addDevice(std::shared_ptr<Device>&& device_ptr) {
-    auto device_name = device_ptr->getName();
-    if (m_device_map.contains(device_name)) {
-        std::cerr << std::format("{} already exist in SmartManager device list.\n", device_name);
-        return false;
-    } else {
-        m_device_names.push_back(device_name);
-        m_device_map.insert({device_name, std::move(device_ptr)});
-        return true;
+#include <algorithm>
+#include <functional>
+
+std::optional<DeviceId> SmartManager::addDevice(std::shared_ptr<Device>&& device_ptr) {
+    const auto& device_name = device_ptr->getName();
+    if (m_device_ids.contains(device_name)) {
+        Log::error("{} already exist in SmartManager device list.", device_name);
+        return std::nullopt;
     }
+
+    auto id = static_cast<DeviceId>(m_devices.size());
+    m_device_ids.emplace(device_name, id);
+    m_kinds.push_back(device_ptr->getKind());
+    m_names.push_back(device_name);
+    m_devices.push_back(std::move(device_ptr));
+    m_data.emplace_back();
+    m_ttimes.push_back(0);
+    if (m_recorder.isOpen()) {
+        Checkpoint::writeDevice(m_recorder.begin(CommandLog::Event::eAddDevice), *m_devices[id]);
+        m_recorder.end();
+    }
+    return id;
 }
 
-bool SmartManager::addSingleData(std::string device_name, std::shared_ptr<DeviceData>&& data_ptr) {
-    if (!m_device_map.contains(device_name)) {
-        std::cerr << std::format(
-            "{} doesn't exist in SmartManager device list. Use addDevice() first.\n", device_name
-        );
+std::optional<DeviceId> SmartManager::findDevice(const std::string& device_name) const {
+    if (auto it = m_device_ids.find(device_name); it != m_device_ids.end())
+        return it->second;
+    Log::error("{} doesn't exist in SmartManager device list. Use addDevice() first.", device_name);
+    return std::nullopt;
+}
+
+bool SmartManager::addSingleData(DeviceId id, std::shared_ptr<DeviceData>&& data_ptr) {
+    if (id >= m_devices.size()) {
+        Log::error("Device id {} doesn't exist in SmartManager device list.", id);
         return false;
     }
+    if (data_ptr != nullptr && !accepts(id, *data_ptr))
+        return false;
 
-    /// [] operator gives default value (the empty vector in our case) when the key doesn't exist.
-    m_data_map[device_name].push_back(std::move(data_ptr));
+    if (data_ptr != nullptr)
+        data_ptr->cmd_id = m_next_cmd_id++;
+    recordCommand(id, data_ptr.get());
+    m_data[id].push_back(std::move(data_ptr));
     return true;
 }
 
-bool SmartManager::addMultipleData(std::string device_name, DataList&& data) {
+bool SmartManager::addSingleData(
+    const std::string& device_name, std::shared_ptr<DeviceData>&& data_ptr
+) {
+    auto id = findDevice(device_name);
+    return id && addSingleData(*id, std::move(data_ptr));
+}
+
+bool SmartManager::addMultipleData(DeviceId id, DataList&& data) {
+    if (id >= m_devices.size()) {
+        Log::error("Device id {} doesn't exist in SmartManager device list.", id);
+        return false;
+    }
+    for (const auto& data_ptr : data) {
+        if (data_ptr != nullptr && !accepts(id, *data_ptr))
+            return false;
+    }
+
+    for (auto& data_ptr : data) {
+        if (data_ptr != nullptr)
+            data_ptr->cmd_id = m_next_cmd_id++;
+        recordCommand(id, data_ptr.get());
+    }
     // Always move elements (regardless of original value category)
-    std::move(data.begin(), data.end(), std::back_inserter(m_data_map[device_name]));
+    std::move(data.begin(), data.end(), std::back_inserter(m_data[id]));
     // Explicitly clear to emphasize invalidation (optional but clear)
     data.clear();
     return true;
 }
 
-bool SmartManager::addTravleTime(std::string device_name, uint32_t&& ttime) {
-    if (!m_device_map.contains(device_name)) {
-        std::cerr << std::format(
-            "{} doesn't exist in SmartManager device list. Use addDevice() first.\n", device_name
-        );
+bool SmartManager::addMultipleData(const std::string& device_name, DataList&& data) {
+    auto id = findDevice(device_name);
+    return id && addMultipleData(*id, std::move(data));
+}
+
+bool SmartManager::submit(DeviceId id, std::shared_ptr<DeviceData>&& data_ptr) {
+    if (id >= m_devices.size()) {
+        Log::error("Device id {} doesn't exist in SmartManager device list.", id);
+        return false;
+    }
+    if (data_ptr != nullptr && !accepts(id, *data_ptr))
+        return false;
+
+    Command command = {id, std::move(data_ptr)};
+    if (!m_ingress.tryPush(std::move(command))) {
+        data_ptr = std::move(command.data);
+        return false;
+    }
+    return true;
+}
+
+void SmartManager::drainIngress() {
+    Command command;
+    while (m_ingress.tryPop(command)) {
+        if (command.data != nullptr)
+            command.data->cmd_id = m_next_cmd_id++;
+        recordCommand(command.id, command.data.get());
+        m_data[command.id].push_back(std::move(command.data));
+    }
+}
+
+bool SmartManager::addTravleTime(DeviceId id, uint32_t&& ttime) {
+    if (id >= m_devices.size()) {
+        Log::error("Device id {} doesn't exist in SmartManager device list.", id);
         return false;
     }
 
-    m_ttime_map[device_name] = std::move(ttime);
+    m_ttimes[id] = std::move(ttime);
+    if (m_recorder.isOpen()) {
+        auto& out = m_recorder.begin(CommandLog::Event::eTravelTime);
+        out.put(id);
+        out.put(m_ttimes[id]);
+        m_recorder.end();
+    }
     return true;
 }
 
+bool SmartManager::addTravleTime(const std::string& device_name, uint32_t&& ttime) {
+    auto id = findDevice(device_name);
+    return id && addTravleTime(*id, std::move(ttime));
+}
+
+bool SmartManager::accepts(DeviceId id, const DeviceData& data) const {
+    if (Capability::accepts(m_kinds[id], data))
+        return true;
+    Log::error(
+        "{} rejects DeviceOpId::{} / DeviceMfId::{}: not supported by {}.",
+        m_names[id],
+        magic_enum::enum_name(data.op_id),
+        magic_enum::enum_name(data.mf_id),
+        magic_enum::enum_name(m_kinds[id])
+    );
+    return false;
+}
+
+void SmartManager::setParallel(size_t num_threads, Scheduler scheduler) {
+    if (num_threads <= 1) {
+        m_pool = nullptr;
+    } else if (scheduler == Scheduler::eWorkStealing) {
+        m_pool = std::make_unique<WorkStealingPool>(num_threads);
+    } else {
+        m_pool = std::make_unique<ThreadPool>(num_threads);
+    }
+}
+
 void SmartManager::operate() {
-    if (m_device_map.empty()) {
-        std::cout << "No device registered, thus nothing happened.\n";
+    // Commands submitted while this round runs wait for the next one.
+    drainIngress();
+    if (m_recorder.isOpen()) {
+        m_recorder.begin(CommandLog::Event::eOperate);
+        m_recorder.end();
+    }
+
+    if (m_devices.empty()) {
+        Log::info("No device registered, thus nothing happened.");
         return;
     }
 
-    for (auto& device_name : m_device_names) {
-        auto& device = m_device_map[device_name];
-        std::cout << std::string(20, '=')
-                  << std::format("{} at {}", device->getName(), device->getCurrentTime())
-                  << std::string(20, '=') << std::endl;
+    // Resolve every session on this thread; the vectors are never touched concurrently.
+    std::vector<Session> sessions;
+    sessions.reserve(m_devices.size());
+    m_batches.clear();
+    for (const auto& data : m_data) {
+        for (const auto& data_ptr : data) {
+            m_batches.push_back(data_ptr.get());
+        }
+    }
+    size_t offset = 0;
+    for (DeviceId id = 0; id < m_devices.size(); id++) {
+        Session session = {m_devices[id].get(), nullptr, {}, 0};
+        // no operation for this device, see Device::logOperation()
+        if (!m_data[id].empty()) {
+            session.data = &m_data[id];
+            session.batch = std::span(m_batches).subspan(offset, m_data[id].size());
+            session.ttime = m_ttimes[id];
+            offset += m_data[id].size();
+        }
+        sessions.push_back(session);
+    }
 
-        if (!m_data_map.contains(device_name)) {
-            // no operation for this device, see Device::logOperation()
-            m_data_map[device_name].push_back(nullptr);
-            continue;
+    if (SimClock::isSimulated()) {
+        // Devices schedule their own completions and travels on the engine, which jumps the
+        // virtual clock from one to the next. The round is over once every session is logged;
+        // what finishes later stays queued for the next round.
+        Device::attachEngine(&m_engine);
+        size_t open = sessions.size();
+        auto close = [this, &open] {
+            if (--open == 0)
+                m_engine.stop();
+        };
+        // Serial: each session starts when the one before it is logged, as its own event so a
+        // long chain of instant sessions doesn't nest.
+        std::function<void(size_t)> start = [&](size_t i) {
+            operateDevice(sessions[i], [&, i] {
+                close();
+                if (i + 1 < sessions.size())
+                    m_engine.schedule(SimClock::now(), [&, i] { start(i + 1); });
+            });
+        };
+        if (m_pool) {
+            // Concurrent in simulated time: every session starts now and they interleave.
+            for (const auto& session : sessions) {
+                m_engine.schedule(SimClock::now(), [this, &session, close] {
+                    operateDevice(session, close);
+                });
+            }
+        } else {
+            m_engine.schedule(SimClock::now(), [&] { start(0); });
+        }
+        m_engine.run();
+        Device::attachEngine(nullptr);
+    } else if (m_pool) {
+        for (const auto& session : sessions) {
+            m_pool->submit([this, &session] { operateDevice(session); });
         }
+        m_pool->wait();
+    } else {
+        for (const auto& session : sessions) {
+            operateDevice(session);
+        }
+    }
+
+    // Bulk free: releasing the data returns the blocks, then the pool rewinds in one step.
+    // Data a WasherDryer still holds in its bins keeps its block until the bin lets go.
+    for (auto& data : m_data) {
+        data.clear();
+    }
+    m_data_pool.reset();
+    return;
+}
+
+void SmartManager::operateDevice(const Session& session, EventEngine::Action done) {
+    auto* device = session.device;
+    bool binary = m_op_log.isOpen();
+    if (binary) {
+        device->recordSession();
+    } else {
+        Log::info(
+            "{0}{1} at {2}{0}", std::string(20, '='), device->getName(), device->getCurrentTime()
+        );
+    }
 
-        for (auto& data : m_data_map[device_name]) {
-            device->operate(data);
-            device->malfunction(data);
+    if (session.data != nullptr) {
+        device->operateBatch(session.batch);
+
+        device->timeTravel(session.ttime);
+    }
+
+    device->afterTravel([this, &session, binary, done = std::move(done)] {
+        auto* device = session.device;
+        if (session.data != nullptr) {
+            for (const auto& data : *session.data) {
+                if (binary)
+                    device->recordOperation(data.get());
+                else
+                    device->logOperation(data.get());
+            }
+        }
+
+        // One write per session, so records of parallel sessions don't interleave.
+        if (binary)
+            m_op_log.write(device->getRecords());
+        device->clearRecords();
+        if (done)
+            done();
+    });
+}
+
+bool SmartManager::saveCheckpoint(const std::string& path) {
+    drainIngress();
+
+    Checkpoint::Writer out;
+    out.put(Checkpoint::K_MAGIC);
+    out.put(Checkpoint::K_VERSION);
+    writeState(out);
+    return out.commit(path);
+}
+
+bool SmartManager::restoreCheckpoint(const std::string& path) {
+    if (!m_devices.empty()) {
+        Log::error("Restore {} into an empty SmartManager, this one has devices.", path);
+        return false;
+    }
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        Log::error("Can't open checkpoint {}", path);
+        return false;
+    }
+
+    Checkpoint::Reader in(file.getText());
+    char magic[sizeof(Checkpoint::K_MAGIC)] = {};
+    uint32_t version = 0;
+    if (!in.get(magic) || !std::ranges::equal(magic, Checkpoint::K_MAGIC) || !in.get(version) ||
+        version != Checkpoint::K_VERSION) {
+        Log::error("{} is not a version {} checkpoint.", path, Checkpoint::K_VERSION);
+        return false;
+    }
+    if (!readState(in) || !in.atEnd()) {
+        Log::error("Checkpoint {} is corrupt, nothing restored.", path);
+        return false;
+    }
+    return true;
+}
+
+void SmartManager::writeState(Checkpoint::Writer& out) const {
+    out.put(m_next_cmd_id);
+    auto* room = Device::getRoom();
+    out.put(room != nullptr);
+    out.put(room != nullptr ? room->getTemp() : 0.f);
+
+    out.put(static_cast<uint32_t>(m_devices.size()));
+    for (DeviceId id = 0; id < m_devices.size(); id++) {
+        Checkpoint::writeDevice(out, *m_devices[id]);
+        out.put(m_ttimes[id]);
+        out.put(static_cast<uint32_t>(m_data[id].size()));
+        for (const auto& data : m_data[id]) {
+            out.put(data != nullptr);
+            if (data != nullptr)
+                out.putData(*data);
         }
+    }
+}
 
-        device->timeTravel(m_ttime_map[device_name]);
+bool SmartManager::readState(Checkpoint::Reader& in) {
+    // Everything is parsed into local lists first, so a corrupt state changes nothing.
+    uint32_t next_cmd_id = 0;
+    bool has_room = false;
+    float room_temp = 0.f;
+    uint32_t num_devices = 0;
+    if (!in.get(next_cmd_id) || !in.get(has_room) || !in.get(room_temp) || !in.get(num_devices))
+        return false;
 
-        for (const auto& data : m_data_map[device_name]) {
-            device->logOperation(data);
+    std::vector<std::shared_ptr<Device>> devices;
+    std::vector<uint32_t> ttimes;
+    std::vector<DataList> pending;
+    for (uint32_t i = 0; i < num_devices && in.ok(); i++) {
+        auto device = Checkpoint::readDevice(in);
+        uint32_t ttime = 0;
+        uint32_t count = 0;
+        if (device == nullptr || !in.get(ttime) || !in.get(count))
+            break;
+        DataList data_list;
+        data_list.reserve(count);
+        for (uint32_t j = 0; j < count && in.ok(); j++) {
+            bool present = false;
+            if (!in.get(present) || !present) {
+                data_list.emplace_back();
+                continue;
+            }
+            auto data = createData();
+            if (!in.getData(*data))
+                break;
+            data_list.push_back(std::move(data));
         }
+        devices.push_back(std::move(device));
+        ttimes.push_back(ttime);
+        pending.push_back(std::move(data_list));
     }
+    if (!in.ok() || devices.size() != num_devices)
+        return false;
 
-    return;
+    for (uint32_t i = 0; i < num_devices; i++) {
+        auto id = addDevice(std::move(devices[i]));
+        if (!id) {
+            // Duplicate names can only come from a hand-edited file; undo the partial restore.
+            m_device_ids.clear();
+            m_devices.clear();
+            m_kinds.clear();
+            m_names.clear();
+            m_data.clear();
+            m_ttimes.clear();
+            return false;
+        }
+        m_ttimes[*id] = ttimes[i];
+        m_data[*id] = std::move(pending[i]);
+    }
+    m_next_cmd_id = next_cmd_id;
+    if (has_room) {
+        if (auto* room = Device::getRoom())
+            room->setTemp(room_temp);
+        else
+            connectToRoom(std::make_shared<Room>(room_temp));
+    }
+    return true;
+}
+
+void SmartManager::recordCommand(DeviceId id, const DeviceData* data) {
+    if (!m_recorder.isOpen())
+        return;
+    auto& out = m_recorder.begin(CommandLog::Event::eCommand);
+    out.put(id);
+    out.put(data != nullptr);
+    if (data != nullptr)
+        out.putData(*data);
+    m_recorder.end();
+}
+
+bool SmartManager::startRecording(const std::string& path) {
+    drainIngress();
+    if (!m_recorder.open(path)) {
+        Log::error("Can't create recording {}", path);
+        return false;
+    }
+    writeState(m_recorder.begin(CommandLog::Event::eState));
+    m_recorder.end();
+    return true;
+}
+
+bool SmartManager::replay(const std::string& path) {
+    if (!m_devices.empty()) {
+        Log::error("Replay {} into an empty SmartManager, this one has devices.", path);
+        return false;
+    }
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        Log::error("Can't open recording {}", path);
+        return false;
+    }
+
+    Checkpoint::Reader header(file.getText());
+    char magic[sizeof(CommandLog::K_MAGIC)] = {};
+    uint32_t version = 0;
+    SimClock::rep start = 0;
+    if (!header.get(magic) || !std::ranges::equal(magic, CommandLog::K_MAGIC) ||
+        !header.get(version) || version != CommandLog::K_VERSION || !header.get(start)) {
+        Log::error("{} is not a version {} recording.", path, CommandLog::K_VERSION);
+        return false;
+    }
+
+    // Back to the recorded start, so every time in the log comes out as it did then.
+    setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    SimClock::resetTo(SimClock::time_point(SimClock::duration(start)));
+    Checkpoint::Reader in(header.getRest());
+    size_t num_events = 0;
+    while (!in.atEnd()) {
+        CommandLog::Event event;
+        SimClock::time_point time;
+        if (!in.getEnum(event) || !in.getTime(time))
+            break;
+        if ((num_events++ == 0) != (event == CommandLog::Event::eState))
+            break;
+        // Events are applied when they happened; the devices move the clock in between.
+        SimClock::advanceTo(time);
+
+        bool ok = true;
+        DeviceId id = 0;
+        switch (event) {
+        case CommandLog::Event::eState:
+            ok = readState(in);
+            break;
+        case CommandLog::Event::eAddDevice: {
+            auto device = Checkpoint::readDevice(in);
+            ok = device != nullptr && addDevice(std::move(device)).has_value();
+            break;
+        }
+        case CommandLog::Event::eCommand: {
+            bool present = false;
+            std::shared_ptr<DeviceData> data;
+            if (!in.get(id) || !in.get(present))
+                break;
+            if (present) {
+                data = createData();
+                // The command must get the id it had, or everything after it would differ.
+                ok = in.getData(*data) && data->cmd_id == m_next_cmd_id;
+            }
+            ok = ok && addSingleData(id, std::move(data));
+            break;
+        }
+        case CommandLog::Event::eTravelTime: {
+            uint32_t minutes = 0;
+            ok = in.get(id) && in.get(minutes) && addTravleTime(id, std::move(minutes));
+            break;
+        }
+        case CommandLog::Event::eOperate:
+            operate();
+            break;
+        default:
+            ok = false;
+            break;
+        }
+        if (!ok || !in.ok())
+            break;
+    }
+    if (!in.atEnd() || num_events == 0) {
+        Log::error("Replay of {} diverged or hit corrupt data at event {}.", path, num_events);
+        return false;
+    }
+    return true;
 }
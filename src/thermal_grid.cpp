@@ -0,0 +1,106 @@
+#include "thermal_grid.hpp"
+#include "simd.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+ThermalGrid::ThermalGrid(uint32_t width, uint32_t height, float temp, float diffusivity)
+    : m_width(std::max<uint32_t>(width, 1)), m_height(std::max<uint32_t>(height, 1)),
+      m_stride(m_width + 2), m_diffusivity(diffusivity),
+      m_cur(m_stride * (m_height + 2), temp), m_next(m_cur) {}
+
+float ThermalGrid::getMeanTemp() const {
+    double sum = 0.0;
+    for (uint32_t y = 0; y < m_height; y++) {
+        const float* row = &m_cur[index(0, y)];
+        sum += std::accumulate(row, row + m_width, 0.0);
+    }
+    return static_cast<float>(sum / (static_cast<double>(m_width) * m_height));
+}
+
+size_t ThermalGrid::addSource(uint32_t x, uint32_t y) {
+    Debug::logAssert(x < m_width && y < m_height, "source ({}, {}) is outside the grid", x, y);
+    m_sources.push_back({index(std::min(x, m_width - 1), std::min(y, m_height - 1)), 0.f});
+    return m_sources.size() - 1;
+}
+
+void ThermalGrid::setSourceRate(size_t source, float deg_per_sec) {
+    m_sources[source].rate = deg_per_sec;
+}
+
+void ThermalGrid::advance(float seconds) {
+    if (seconds <= 0.f)
+        return;
+    auto steps = static_cast<uint32_t>(std::ceil(seconds * m_diffusivity / K_MAX_STABLE_STEP));
+    steps = std::max<uint32_t>(steps, 1);
+    float dt = seconds / static_cast<float>(steps);
+    for (uint32_t i = 0; i < steps; i++) {
+        step(dt);
+    }
+}
+
+void ThermalGrid::step(float dt) {
+    Debug::logAssert(
+        dt * m_diffusivity <= K_MAX_STABLE_STEP * 1.0001f,
+        "ThermalGrid::step({}) is unstable, use advance()",
+        dt
+    );
+    for (const auto& source : m_sources) {
+        m_cur[source.cell] += source.rate * dt;
+    }
+
+    fillGhosts();
+    if (m_kernel == Kernel::eSimd)
+        diffuseSimd(m_diffusivity * dt);
+    else
+        diffuseScalar(m_diffusivity * dt);
+    std::swap(m_cur, m_next);
+}
+
+void ThermalGrid::fillGhosts() {
+    // Rows first, then columns, so the corners are filled too (they are never read anyway).
+    std::copy_n(&m_cur[index(0, 0)], m_width, &m_cur[index(0, 0) - m_stride]);
+    std::copy_n(&m_cur[index(0, m_height - 1)], m_width, &m_cur[index(0, m_height - 1) + m_stride]);
+    for (uint32_t y = 0; y < m_height; y++) {
+        m_cur[index(0, y) - 1] = m_cur[index(0, y)];
+        m_cur[index(m_width - 1, y) + 1] = m_cur[index(m_width - 1, y)];
+    }
+}
+
+void ThermalGrid::diffuseScalar(float k) {
+    for (uint32_t y = 0; y < m_height; y++) {
+        size_t row = index(0, y);
+        for (size_t i = row; i < row + m_width; i++) {
+            float c = m_cur[i];
+            float laplacian =
+                m_cur[i - 1] + m_cur[i + 1] + m_cur[i - m_stride] + m_cur[i + m_stride] - 4.f * c;
+            m_next[i] = c + k * laplacian;
+        }
+    }
+}
+
+void ThermalGrid::diffuseSimd(float k) {
+    const auto vk = Simd::broadcast(k);
+    const auto four = Simd::broadcast(4.f);
+    const float* cur = m_cur.data();
+    float* next = m_next.data();
+    for (uint32_t y = 0; y < m_height; y++) {
+        size_t i = index(0, y);
+        size_t row_end = i + m_width;
+        for (; i + Simd::K_LANES <= row_end; i += Simd::K_LANES) {
+            auto c = Simd::load(cur + i);
+            auto laplacian = Simd::load(cur + i - 1) + Simd::load(cur + i + 1) +
+                             Simd::load(cur + i - m_stride) + Simd::load(cur + i + m_stride) -
+                             four * c;
+            Simd::store(next + i, c + vk * laplacian);
+        }
+        // Row tail narrower than a vector.
+        for (; i < row_end; i++) {
+            float laplacian =
+                cur[i - 1] + cur[i + 1] + cur[i - m_stride] + cur[i + m_stride] - 4.f * cur[i];
+            next[i] = cur[i] + k * laplacian;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    num_threads = std::max<size_t>(num_threads, 1);
+    m_workers.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+        m_workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_task_cv.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.push(std::move(task));
+        m_in_flight++;
+    }
+    m_task_cv.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock(m_mutex);
+    m_idle_cv.wait(lock, [this] { return m_in_flight == 0; });
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_task_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_stop && m_tasks.empty())
+                return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+
+        std::lock_guard lock(m_mutex);
+        if (--m_in_flight == 0)
+            m_idle_cv.notify_all();
+    }
+}
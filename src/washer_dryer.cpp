@@ -1,30 +1,16 @@
 #include "washer_dryer.hpp"
-#include <thread>
+#include "checkpoint.hpp"
 #include <utils.hpp>
 
-void WasherDryer::operate(std::shared_ptr<DeviceData> data) {
+void WasherDryer::operate(DeviceData* data) {
+    static_assert(Capability::handlesOnlyAccepted(K_OP_TABLE, DeviceKind::eWasherDryer));
     if (data == nullptr || !m_on)
         return;
 
-    switch (data->op_id) {
-    case DeviceOpId::eWashDryerCombo:
-        // auto call Dry() after Wash() finishes
-        wash(data);
-        break;
-    case DeviceOpId::eWashDryerWashOnly:
-        wash(data);
-        break;
-    case DeviceOpId::eWashDryerDryOnly:
-        dry(data);
-        break;
-    default:
-        Device::operate();
-        data->logOpId();
-        break;
-    }
+    dispatch(K_OP_TABLE, data);
 }
 
-void WasherDryer::malfunction(std::shared_ptr<DeviceData> data) {
+void WasherDryer::malfunction(DeviceData* data) {
     if (data == nullptr || !m_on)
         return;
 
@@ -39,7 +25,7 @@ void WasherDryer::malfunction(std::shared_ptr<DeviceData> data) {
         break;
     }
     case DeviceMfId::eBroken:
-        std::cerr << getName() << " are leaking! See if Super Mario can help!" << std::endl;
+        Log::error("{} are leaking! See if Super Mario can help!", getName());
         break;
     default:
         // eNormal
@@ -48,134 +34,174 @@ void WasherDryer::malfunction(std::shared_ptr<DeviceData> data) {
     }
 }
 
-uint32_t WasherDryer::timeTravel(const uint32_t duration_sec) {
+uint32_t WasherDryer::timeTravel(const uint32_t duration_min) {
     using namespace std::chrono;
-    auto sim_remaining = seconds(duration_sec);
-    auto constexpr ZERO_SEC = seconds(0);
-    /// Used when duration_sec > 0
-    auto canStep = [this, sim_remaining](bool is_wash) -> bool {
-        auto& timer = is_wash ? m_wash_timer : m_dry_timer;
-        auto& bin = is_wash ? m_wash_bin : m_dry_bin;
-        if (!timer.running || bin.empty())
-            return false;
+    if (duration_min == 0) {
+        auto start = SimClock::now();
+        // finish 1 wash and 1 dry if we should; the dry one is looked at once the wash is done
+        auto dry = [this] {
+            if (!m_dry_bin.empty() && m_dry_timer.running)
+                performNext(false, [] {});
+        };
+        if (!m_wash_bin.empty() && m_wash_timer.running)
+            performNext(true, dry);
+        else
+            dry();
 
-        auto timeSpent = duration_cast<seconds>(system_clock::now() - timer.t_start);
-        if (timeSpent > timer.t_total_sec) {
-            // It finishes even before timeTravel simulation.
-            return true;
-        }
-        auto time2Finish = timer.t_total_sec - timeSpent;
-        return (time2Finish <= sim_remaining);
-    };
+        return duration_cast<minutes>(SimClock::now() - start).count();
+    }
 
-    if (duration_sec == 0) {
-        auto start = system_clock::now();
-        // finish 1 wash and 1 dry if we should
-        if (!m_wash_bin.empty() && m_wash_timer.running)
-            performNext(true);
-        if (!m_dry_bin.empty() && m_dry_timer.running)
-            performNext(false);
-
-        return duration_cast<seconds>(system_clock::now() - start).count();
-    } else {
-        bool wash_flag = true; // alternate
-        while (sim_remaining > ZERO_SEC) {
-            if (canStep(wash_flag)) {
-                auto start = system_clock::now();
-                performNext(wash_flag);
-                sim_remaining -= duration_cast<seconds>(system_clock::now() - start);
-            } else {
-                /// Since we start with wash, we must check dry when no more wash can be done.
-                /// But if no more dry can be done, we can break
-                if (!wash_flag)
-                    break;
-            }
-            wash_flag = !wash_flag;
-        }
+    auto end = SimClock::now() + minutes(duration_min);
+    travelFor(minutes(duration_min), [this, end] { settleUntil(end); });
+    return duration_min;
+}
 
-        std::this_thread::sleep_for(sim_remaining);
-        return duration_sec;
+void WasherDryer::settleUntil(SimClock::time_point end) {
+    // Only the front job of each bin runs, so the next thing to happen is whichever of the two
+    // finishes first. Settling it may start the next job in its bin or a combo in the dryer, both
+    // at its finish time, so every job is looked at once however long the window is.
+    while (true) {
+        auto wash_done = getFinishTime(true);
+        auto dry_done = getFinishTime(false);
+        // Wash first on a tie, so a combo can queue behind the dry job finishing with it.
+        bool is_wash = wash_done <= dry_done;
+        auto done = is_wash ? wash_done : dry_done;
+        if (done > end)
+            break;
+        settle(is_wash, done);
     }
 }
 
-void WasherDryer::wash(std::shared_ptr<DeviceData> data) {
+void WasherDryer::wash(DeviceData* data) { submit(true /* is_wash */, data); }
+
+void WasherDryer::dry(DeviceData* data) { submit(false /* is_wash */, data); }
+
+void WasherDryer::submit(bool is_wash, DeviceData* data) {
     Debug::logAssert(data != nullptr, "caller Operate() should filter out nullptr input");
+    auto& timer = is_wash ? m_wash_timer : m_dry_timer;
+    auto& bin = is_wash ? m_wash_bin : m_dry_bin;
 
     if (data->dfloat > k_total_volume) {
-        data->dstring = std::format(
-            "You put too much cloth ({}) more than total volume {}.\n", data->dfloat, k_total_volume
-        );
+        auto& record = emit(*data, OpEvent::eClothTooMuch);
+        record.f0 = data->dfloat;
+        record.f1 = k_total_volume;
 
         data->success = false;
         return;
     }
+    // Back-pressure: the caller retries after a time travel has made room.
+    if (!bin.tryPush({data->cmd_id, data->op_id, data->mf_id, data->dint})) {
+        auto& record = emit(*data, OpEvent::eBinFull);
+        record.i0 = static_cast<int32_t>(bin.size());
+        record.flag = is_wash;
 
-    // To simplify cases, all jobs should go thru the bin
-    m_wash_bin.push_back(data);
-
-    if (m_wash_timer.running) {
-        // Every non-0th-submission goes here
-        performNext(true /* is_wash */);
+        data->success = false;
+        return;
     }
-    // before submitting the next wash
-    Debug::logAssert(!m_wash_bin.empty(), "m_wash_bin should not be empty");
-    Debug::logAssert(!m_wash_timer.running, "m_wash_timer should not be running");
-    m_wash_timer.begin(data->dint);
+
+    data->success = true;
+    // Only a job at the front runs; behind a stalled washer it waits like any other.
+    if (bin.size() == 1)
+        start(is_wash, SimClock::now());
 }
 
-void WasherDryer::dry(std::shared_ptr<DeviceData> data) {
-    Debug::logAssert(data != nullptr, "caller Operate() should filter out nullptr input");
+void WasherDryer::performNext(bool is_wash, EventEngine::Action then) {
+    auto done = getFinishTime(is_wash);
+    // sim till the end of the running job first
+    travelFor(done - SimClock::now(), [this, is_wash, done, then = std::move(then)] {
+        // With an engine, the wake at `done` came first and may have settled it already.
+        if (getFinishTime(is_wash) == done)
+            settle(is_wash, done);
+        then();
+    });
+}
 
-    if (data->dfloat > k_total_volume) {
-        data->dstring = std::format(
-            "You put too much cloth ({}) more than total volume {}.\n", data->dfloat, k_total_volume
-        );
+void WasherDryer::start(bool is_wash, SimClock::time_point at) {
+    auto& timer = is_wash ? m_wash_timer : m_dry_timer;
+    const auto& bin = is_wash ? m_wash_bin : m_dry_bin;
+    timer.beginAt(at, std::chrono::minutes(bin.front().minutes));
+    wakeAt(getFinishTime(is_wash));
+}
 
-        data->success = false;
-        return;
-    }
+void WasherDryer::settle(bool is_wash, SimClock::time_point done) {
+    auto& timer = is_wash ? m_wash_timer : m_dry_timer;
+    auto& bin = is_wash ? m_wash_bin : m_dry_bin;
 
-    // To simplify cases, all jobs should go thru the bin
-    m_dry_bin.push_back(data);
+    // log, not curr time, but time when job finished
+    timer.stop();
+    const Job& job = bin.front();
+    auto& record = emit(job, OpEvent::eJobDone, done);
+    record.i0 = job.minutes;
+    record.flag = is_wash;
 
-    if (m_dry_timer.running) {
-        // Every non-0th-submission goes here
-        performNext(false /* is_wash */);
+    // Laundry can't be sent back: a combo stays in the washer until the dryer's bin has room.
+    if (is_wash && job.op_id == DeviceOpId::eWashDryerCombo && m_dry_bin.full()) {
+        emit(job, OpEvent::eComboWaits, done).i0 = static_cast<int32_t>(m_dry_bin.size());
+        return;
     }
-    // before submitting the next dry
-    Debug::logAssert(!m_dry_bin.empty(), "m_dry_bin should not be empty");
-    Debug::logAssert(!m_dry_timer.running, "m_dry_timer should not be running");
-    m_dry_timer.begin(data->dint);
+    release(is_wash, done);
+    if (!is_wash && isWashStalled())
+        release(true /* is_wash */, done);
 }
 
-void WasherDryer::performNext(bool is_wash) {
-    auto& timer = is_wash ? m_wash_timer : m_dry_timer;
+void WasherDryer::release(bool is_wash, SimClock::time_point done) {
     auto& bin = is_wash ? m_wash_bin : m_dry_bin;
 
-    if (int remaining_time = timer.checkRemainingTime(); remaining_time > 0) {
-        // sim till the end of previous job first
-        std::this_thread::sleep_for(std::chrono::seconds(remaining_time));
-        timer.stop();
-    }
-    // mark success and pop from bin
-    auto prev_data = bin.front();
-    bin.pop_front();
-    prev_data->success = true;
-    prev_data->dstring += std::format(
-        "{} job completes after {} seconds, at {:%T}. ",
-        is_wash ? "Wash" : "Dry",
-        prev_data->dint,
-        // not curr time, but time when job finished
-        timer.t_start + timer.t_total_sec
-    );
+    Job job = bin.front();
+    bin.popFront();
+    // The next job in line starts the moment this one is out.
+    if (!bin.empty())
+        start(is_wash, done);
 
     // Check if this is a wash job in a wash-dry combo
-    if (is_wash && prev_data->op_id == DeviceOpId::eWashDryerCombo) {
-        // wash success but not combo
-        prev_data->success = false;
-        // submit to dryer.
-        prev_data->dstring +=
-            std::format("Begin dry in the combo, also take {} seconds; ", prev_data->dint);
-        dry(prev_data);
+    if (is_wash && job.op_id == DeviceOpId::eWashDryerCombo)
+        handOff(job, done);
+}
+
+void WasherDryer::handOff(const Job& job, SimClock::time_point done) {
+    // Same drum size, so a combo that fit the washer fits the dryer; `settle()` made room.
+    bool pushed = m_dry_bin.tryPush(job);
+    Debug::logAssert(pushed, "WasherDryer::handOff() into a full dryer bin");
+    // submit to dryer.
+    emit(job, OpEvent::eComboHandoff, done).i0 = job.minutes;
+    if (!m_dry_timer.running)
+        start(false /* is_wash */, done);
+}
+
+SimClock::time_point WasherDryer::getFinishTime(bool is_wash) const {
+    const auto& timer = is_wash ? m_wash_timer : m_dry_timer;
+    return timer.running ? timer.t_start + timer.t_total_sec : SimClock::time_point::max();
+}
+
+void WasherDryer::saveState(Checkpoint::Writer& out) const {
+    Device::saveState(out);
+    for (bool is_wash : {true, false}) {
+        const auto& bin = is_wash ? m_wash_bin : m_dry_bin;
+        out.putTimer(is_wash ? m_wash_timer : m_dry_timer);
+        out.put(static_cast<uint32_t>(bin.size()));
+        for (size_t i = 0; i < bin.size(); i++) {
+            out.put(bin[i].cmd_id);
+            out.put(bin[i].op_id);
+            out.put(bin[i].mf_id);
+            out.put(bin[i].minutes);
+        }
+    }
+}
+
+bool WasherDryer::loadState(Checkpoint::Reader& in) {
+    if (!Device::loadState(in))
+        return false;
+    for (bool is_wash : {true, false}) {
+        auto& bin = is_wash ? m_wash_bin : m_dry_bin;
+        uint32_t count = 0;
+        if (!in.getTimer(is_wash ? m_wash_timer : m_dry_timer) || !in.get(count) || !bin.empty())
+            return false;
+        for (uint32_t i = 0; i < count; i++) {
+            Job job;
+            if (!in.get(job.cmd_id) || !in.getEnum(job.op_id) || !in.getEnum(job.mf_id) ||
+                !in.get(job.minutes) || !bin.tryPush(job))
+                return false;
+        }
     }
+    return true;
 }
@@ -0,0 +1,97 @@
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(size_t num_threads) {
+    num_threads = std::max<size_t>(num_threads, 1);
+    for (size_t i = 0; i < num_threads; i++) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    m_threads.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+        m_threads.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_task_cv.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    size_t index = t_pool == this
+                       ? t_index
+                       : m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    m_in_flight.fetch_add(1);
+    {
+        // Counted before the push, so a thief that takes the task right away can't decrement
+        // first and wrap the count. Under the sleep lock, so a worker checking before it sleeps
+        // can't miss it; one woken before the push finds nothing and goes back to waiting.
+        std::lock_guard lock(m_sleep_mutex);
+        m_queued.fetch_add(1);
+    }
+    {
+        std::lock_guard lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    m_task_cv.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock lock(m_sleep_mutex);
+    m_idle_cv.wait(lock, [this] { return m_in_flight.load() == 0; });
+}
+
+bool WorkStealingPool::popLocal(size_t index, Task& task) {
+    auto& queue = *m_queues[index];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, Task& task) {
+    // Start from the neighbour so thieves don't all hit worker 0.
+    for (size_t offset = 1; offset < m_queues.size(); offset++) {
+        auto& victim = *m_queues[(thief + offset) % m_queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (victim.tasks.empty())
+            continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        m_steal_count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    t_pool = this;
+    t_index = index;
+
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            m_queued.fetch_sub(1);
+            task();
+            if (m_in_flight.fetch_sub(1) == 1) {
+                std::lock_guard lock(m_sleep_mutex);
+                m_idle_cv.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock(m_sleep_mutex);
+        m_task_cv.wait(lock, [this] { return m_stop || m_queued.load() > 0; });
+        if (m_stop && m_queued.load() == 0)
+            return;
+    }
+}
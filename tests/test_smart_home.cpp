@@ -1,8 +1,682 @@
 // Placeholder content
 
+#include "ac_fleet.hpp"
+#include "air_fryer.hpp"
 #include "catch.hpp"
+#include "config_loader.hpp"
+#include "event_engine.hpp"
+#include "real_ac.hpp"
+#include "room.hpp"
+#include "smart_manager.hpp"
+#include "simd.hpp"
+#include "thermal_grid.hpp"
+#include "washer_dryer.hpp"
 
-int main() {
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_ACS = 64;
+
+bool check(bool ok, std::string_view what) {
+    if (!ok)
+        Log::error("FAILED: {}", what);
+    return ok;
+}
+
+std::string tempPath(std::string_view name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+/// @brief A command for driving a device directly, without a manager.
+DeviceData makeData(DeviceOpId op_id, float dfloat = 0.f, int dint = 0) {
+    DeviceData data = {};
+    data.op_id = op_id;
+    data.mf_id = DeviceMfId::eNormal;
+    data.dfloat = dfloat;
+    data.dint = dint;
+    return data;
+}
+
+/// @brief Minutes after `start` at which `device` emitted `event`, in emission order.
+std::vector<int64_t> eventMinutes(const Device& device, OpEvent event, SimClock::time_point start) {
+    using namespace std::chrono;
+    auto start_ns = duration_cast<nanoseconds>(start.time_since_epoch()).count();
+    auto minute_ns = duration_cast<nanoseconds>(1min).count();
+    std::vector<int64_t> result;
+    for (const auto& record : device.getRecords()) {
+        if (record.event == event)
+            result.push_back((record.time_ns - start_ns) / minute_ns);
+    }
+    return result;
+}
+
+std::shared_ptr<DeviceData> makeCommand(
+    SmartManager& manager, DeviceOpId op_id, float dfloat = 0.f, int dint = 0, bool dbool = false,
+    std::string dstring = ""
+) {
+    auto data = manager.createData();
+    data->op_id = op_id;
+    data->mf_id = DeviceMfId::eNormal;
+    data->dfloat = dfloat;
+    data->dint = dint;
+    data->dbool = dbool;
+    data->dstring = std::move(dstring);
+    return data;
+}
+
+/// @brief 64 threads add to one `Room` at once; every single delta must land.
+bool testRoomAddTemp() {
+    constexpr size_t ADDS_PER_THREAD = 10000;
+    Room room(25.f);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_ACS; t++) {
+        threads.emplace_back([&room] {
+            for (size_t i = 0; i < ADDS_PER_THREAD; i++) {
+                room.addTemp(0.25f);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return check(
+        room.getTemp() == 25.f + NUM_ACS * ADDS_PER_THREAD * 0.25f, "Room::addTemp() lost updates"
+    );
+}
+
+/// @brief Every AC runs `rounds` one-minute heating sessions on the shared room.
+/// @return Final room temperature.
+float runAcs(bool concurrent) {
+    constexpr int ROUNDS = 3;
+    auto room = std::make_shared<Room>(25.f);
+    Device::loginRoom(room);
+
+    std::vector<std::unique_ptr<RealAC>> acs;
+    std::vector<DeviceData> commands(NUM_ACS);
+    for (size_t i = 0; i < NUM_ACS; i++) {
+        acs.push_back(std::make_unique<RealAC>(1000 + 10 * static_cast<uint32_t>(i)));
+        commands[i].op_id = DeviceOpId::eRealAcOpenForMins;
+        commands[i].dint = 1;
+        commands[i].dbool = true;
+        commands[i].dstring = "eFull";
+    }
+
+    auto runOne = [&](size_t i) {
+        for (int round = 0; round < ROUNDS; round++) {
+            acs[i]->operate(&commands[i]);
+            acs[i]->timeTravel(1);
+        }
+    };
+    if (concurrent) {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < NUM_ACS; i++) {
+            threads.emplace_back(runOne, i);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    } else {
+        for (size_t i = 0; i < NUM_ACS; i++) {
+            runOne(i);
+        }
+    }
+    return room->getTemp();
+}
+
+/// @brief 64 `RealAC`s heat the room from their own threads. Each session adds a fixed amount, so
+/// the concurrent result must equal a serial run exactly.
+bool testConcurrentAcs() {
+    // Serial on virtual time is instant; concurrent runs for real, one simulated minute ~17 ms.
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    float serial = runAcs(false);
+    SimClock::setTimeScale(TimeScale::K_HOUR_PER_SEC);
+    float concurrent = runAcs(true);
+
+    bool ok = check(serial > 25.f, "RealAC sessions didn't heat the room");
+    ok &= check(concurrent == serial, "concurrent RealACs lost room updates");
+    Log::info("64 RealACs: serial {} / concurrent {} Celsius degree", serial, concurrent);
+    return ok;
+}
+
+/// @brief `AcFleet::advance()` heats a shared room like the same `RealAC`s, each opened and time
+/// travelled on its own, for a unit count that leaves a SIMD tail and sessions that end early.
+bool testAcFleetMatchesRealAc() {
+    constexpr uint32_t NUM_UNITS = 2 * uint32_t(Simd::K_LANES) + 3;
+    constexpr uint32_t TRAVEL_MIN = 3;
+    constexpr int TRAVELS = 2;
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    auto room = std::make_shared<Room>(20.f);
+    Device::loginRoom(room);
+    AcFleet fleet;
+    auto fleet_room = fleet.addRoom(20.f);
+
+    for (uint32_t i = 0; i < NUM_UNITS; i++) {
+        uint32_t power = 800 + 150 * i;
+        auto mode = static_cast<AcFleet::Mode>(i % 3);
+        bool heat = i % 4 != 0;
+        uint32_t mins = i % 2 == 0 ? 2 : 5; // 2 min runs out within the first travel
+        DeviceData data;
+        data.op_id = DeviceOpId::eRealAcOpenForMins;
+        data.dint = static_cast<int>(mins);
+        data.dbool = heat;
+        data.dstring = magic_enum::enum_name(mode);
+        RealAC ac(power);
+        ac.operate(&data);
+        for (int t = 0; t < TRAVELS; t++) {
+            ac.timeTravel(TRAVEL_MIN);
+        }
+        fleet.openForMins(fleet.addUnit(fleet_room, power), mins, heat, mode);
+    }
+    for (int t = 0; t < TRAVELS; t++) {
+        fleet.advance(TRAVEL_MIN * 60.f);
+    }
+
+    bool ok = check(
+        std::abs(fleet.getRoomTemp(fleet_room) - room->getTemp()) < 1e-3f,
+        std::format(
+            "AcFleet room at {} Celsius degree, RealACs at {}",
+            fleet.getRoomTemp(fleet_room),
+            room->getTemp()
+        )
+    );
+    ok &= check(room->getTemp() != 20.f, "RealAC sessions didn't change the room");
+
+    // No power left at eLow: the unit can never reach the target, so it stays idle.
+    auto weak = fleet.addUnit(fleet_room, 1);
+    fleet.openTillDeg(weak, 30.f, AcFleet::Mode::eLow);
+    ok &= check(!fleet.isRunning(weak), "AcFleet::openTillDeg() ran a unit with no power");
+    return ok;
+}
+
+/// @brief The SIMD stencil matches the scalar reference after many steps, for widths that leave a
+/// row tail narrower than a vector or are narrower than one, with sources on the borders.
+bool testThermalGridKernels() {
+    constexpr uint32_t STEPS = 200;
+    bool ok = true;
+    for (uint32_t width : {1u, 3u, 4u, 5u, 8u, 9u, 13u, 2 * uint32_t(Simd::K_LANES) + 3}) {
+        for (uint32_t height : {1u, 2u, 7u}) {
+            auto run = [&](ThermalGrid::Kernel kernel) {
+                ThermalGrid grid(width, height, 20.f);
+                grid.setKernel(kernel);
+                // Uneven start, so every neighbor and ghost cell matters.
+                for (uint32_t y = 0; y < height; y++) {
+                    for (uint32_t x = 0; x < width; x++) {
+                        grid.setTemp(x, y, 20.f + static_cast<float>((x * 7 + y * 13) % 11));
+                    }
+                }
+                grid.setSourceRate(grid.addSource(0, 0), 0.5f);
+                grid.setSourceRate(grid.addSource(width - 1, height - 1), -0.3f);
+                for (uint32_t i = 0; i < STEPS; i++) {
+                    grid.step(ThermalGrid::K_MAX_STABLE_STEP / ThermalGrid::K_DEFAULT_DIFFUSIVITY);
+                }
+                return grid;
+            };
+            auto scalar = run(ThermalGrid::Kernel::eScalar);
+            auto simd = run(ThermalGrid::Kernel::eSimd);
+            float max_diff = 0.f;
+            for (uint32_t y = 0; y < height; y++) {
+                for (uint32_t x = 0; x < width; x++) {
+                    float diff = std::abs(scalar.getTemp(x, y) - simd.getTemp(x, y));
+                    max_diff = std::max(max_diff, diff);
+                }
+            }
+            ok &= check(
+                max_diff < 1e-3f,
+                std::format("ThermalGrid {}x{}: SIMD off scalar by {}", width, height, max_diff)
+            );
+        }
+    }
+    return ok;
+}
+
+/// @brief A WasherDryer and an AirFryer travel 60 minutes on one engine. Their jobs finish at
+/// different times, and each must be settled at its own time, interleaved with the other device's,
+/// not when the travel ends: a probe every minute sees exactly the events due by then.
+bool testEngineInterleavesDevices() {
+    using namespace std::chrono;
+    constexpr int TRAVEL_MIN = 60;
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    EventEngine engine;
+    Device::attachEngine(&engine);
+    WasherDryer washer_dryer(10.f);
+    AirFryer air_fryer(5.f);
+    auto start = SimClock::now();
+
+    // Washer: combo 0-20 then dries 20-40, wash-only 20-45. Fryer: 0-10 and 0-35.
+    std::vector<DeviceData> washes = {
+        makeData(DeviceOpId::eWashDryerCombo, 5.f, 20),
+        makeData(DeviceOpId::eWashDryerWashOnly, 5.f, 25),
+    };
+    std::vector<DeviceData> cooks = {
+        makeData(DeviceOpId::eAirFryerCook, 2.f, 10),
+        makeData(DeviceOpId::eAirFryerCook, 2.f, 35),
+    };
+    for (auto& data : washes) {
+        washer_dryer.operate(&data);
+    }
+    for (auto& data : cooks) {
+        air_fryer.operate(&data);
+    }
+    Device* devices[] = {&washer_dryer, &air_fryer};
+    std::vector<SimClock::time_point> ended;
+    for (Device* device : devices) {
+        device->timeTravel(TRAVEL_MIN);
+        device->afterTravel([&ended] { ended.push_back(SimClock::now()); });
+    }
+
+    // Half a minute past each minute, so no probe ties with a device event.
+    struct Probe {
+        SimClock::time_point at;
+        size_t emitted;
+        bool none_ahead;
+    };
+    std::vector<Probe> probes;
+    for (int minute = 0; minute < TRAVEL_MIN; minute++) {
+        auto at = start + minutes(minute) + seconds(30);
+        engine.schedule(at, [&probes, &devices, at] {
+            Probe probe = {at, 0, true};
+            for (const Device* device : devices) {
+                probe.emitted += device->getRecords().size();
+                for (const auto& record : device->getRecords()) {
+                    probe.none_ahead &= record.getTime() < at;
+                }
+            }
+            probes.push_back(probe);
+        });
+    }
+    engine.run();
+    Device::attachEngine(nullptr);
 
-    return 0;
-}
\ No newline at end of file
+    bool ok = true;
+    for (const auto& probe : probes) {
+        size_t due = 0;
+        for (const Device* device : devices) {
+            due += std::ranges::count_if(device->getRecords(), [&probe](const OpRecord& record) {
+                return record.getTime() < probe.at;
+            });
+        }
+        auto minute = duration_cast<minutes>(probe.at - start).count();
+        ok &= check(probe.none_ahead, std::format("an event ahead of minute {} came out", minute));
+        ok &= check(probe.emitted == due, std::format("events due by minute {} are late", minute));
+    }
+    ok &= check(probes.size() == TRAVEL_MIN, "the engine skipped a probe");
+    ok &= check(
+        eventMinutes(washer_dryer, OpEvent::eJobDone, start) == std::vector<int64_t>{20, 40, 45},
+        "WasherDryer jobs finished at the wrong times"
+    );
+    ok &= check(
+        eventMinutes(air_fryer, OpEvent::eCookDone, start) == std::vector<int64_t>{10, 35},
+        "AirFryer items finished at the wrong times"
+    );
+    ok &= check(
+        ended == std::vector<SimClock::time_point>(2, start + minutes(TRAVEL_MIN)),
+        "a travel didn't end after its 60 minutes"
+    );
+    return ok;
+}
+
+/// @brief Three combo jobs, fast-forwarded over 3 hours in one `timeTravel()` call, finish at the
+/// same minutes as when stepped through minute by minute.
+bool testWasherDryerFastForward() {
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    auto run = [](bool stepped) {
+        WasherDryer washer_dryer(10.f);
+        auto start = SimClock::now();
+        for (int minutes : {40, 30, 20}) {
+            auto data = makeData(DeviceOpId::eWashDryerCombo, 5.f, minutes);
+            washer_dryer.operate(&data);
+        }
+        if (stepped) {
+            for (int minute = 0; minute < 180; minute++) {
+                washer_dryer.timeTravel(1);
+            }
+        } else {
+            washer_dryer.timeTravel(180);
+        }
+        return eventMinutes(washer_dryer, OpEvent::eJobDone, start);
+    };
+    auto stepped = run(true);
+    auto fast_forward = run(false);
+
+    // Washes end at 40, 70, 90; each dry waits for the dryer: 80, 110, 130.
+    std::vector<int64_t> expected = {40, 70, 80, 90, 110, 130};
+    bool ok = check(stepped == expected, "stepped WasherDryer finished jobs at the wrong times");
+    ok &= check(fast_forward == stepped, "WasherDryer fast-forward differs from stepping");
+    return ok;
+}
+
+/// @brief A wash bin of 2 turns the third job away with `OpEvent::eBinFull` instead of growing,
+/// and takes jobs again once a time travel has finished the running one.
+bool testWasherDryerBinFull() {
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    WasherDryer washer_dryer(10.f, 2);
+    std::vector<DeviceData> jobs(3, makeData(DeviceOpId::eWashDryerWashOnly, 5.f, 30));
+    for (auto& data : jobs) {
+        washer_dryer.operate(&data);
+    }
+    bool ok = check(jobs[0].success && jobs[1].success, "WasherDryer rejected a job with room");
+    ok &= check(!jobs[2].success, "WasherDryer took a job into a full bin");
+
+    size_t bin_full = 0;
+    for (const auto& record : washer_dryer.getRecords()) {
+        if (record.event == OpEvent::eBinFull) {
+            bin_full++;
+            ok &= check(record.flag && record.i0 == 2, "eBinFull names the wrong bin or size");
+        }
+    }
+    ok &= check(bin_full == 1, "a full bin should log eBinFull once");
+
+    washer_dryer.timeTravel(30);
+    auto retry = makeData(DeviceOpId::eWashDryerWashOnly, 5.f, 30);
+    washer_dryer.operate(&retry);
+    ok &= check(retry.success, "WasherDryer bin stays full after a job finished");
+
+    // A combo washed while the dryer's bin is full stalls the washer instead of losing its dry.
+    WasherDryer stalled(10.f, 2);
+    auto start = SimClock::now();
+    std::vector<DeviceData> queue = {
+        makeData(DeviceOpId::eWashDryerDryOnly, 5.f, 60),
+        makeData(DeviceOpId::eWashDryerDryOnly, 5.f, 60),
+        makeData(DeviceOpId::eWashDryerCombo, 5.f, 30),
+        makeData(DeviceOpId::eWashDryerWashOnly, 5.f, 10),
+    };
+    for (auto& data : queue) {
+        stalled.operate(&data);
+        ok &= check(data.success, "WasherDryer rejected a job with room");
+    }
+    stalled.timeTravel(200);
+    // Combo wash done at 30 and held; first dry out at 60 lets it in, and the wash-only job behind
+    // it runs 60-70. The combo's dry follows the second dry job, 120-150.
+    auto done = eventMinutes(stalled, OpEvent::eJobDone, start);
+    ok &= check(
+        done == std::vector<int64_t>{30, 60, 70, 120, 150},
+        std::format("stalled combo finish times {}", done)
+    );
+    ok &= check(
+        eventMinutes(stalled, OpEvent::eComboWaits, start) == std::vector<int64_t>{30},
+        "the combo didn't wait for the dryer once, at 30"
+    );
+    ok &= check(
+        eventMinutes(stalled, OpEvent::eComboHandoff, start) == std::vector<int64_t>{60},
+        "the combo wasn't handed to the dryer once it had room"
+    );
+    return ok;
+}
+
+/// @brief Two items that fit together cook at once and come out in finish order, not in the order
+/// they went in; `timeTravel(0)` runs until the last one is done.
+bool testAirFryerCooksConcurrently() {
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    AirFryer air_fryer(5.f);
+    auto start = SimClock::now();
+    std::vector<DeviceData> items = {
+        makeData(DeviceOpId::eAirFryerCook, 2.f, 30), makeData(DeviceOpId::eAirFryerCook, 2.f, 10)
+    };
+    for (auto& data : items) {
+        air_fryer.operate(&data);
+    }
+    bool ok = check(items[0].success && items[1].success, "AirFryer turned away an item that fits");
+    ok &= check(air_fryer.timeTravel(0) == 30, "AirFryer::timeTravel(0) should run 30 minutes");
+    ok &= check(
+        eventMinutes(air_fryer, OpEvent::eCookDone, start) == std::vector<int64_t>{10, 30},
+        "AirFryer items should finish at 10 and 30 minutes"
+    );
+    return ok;
+}
+
+/// @brief 4, 3 and 1 liters into a 5-liter basket, 10 minutes each. First-fit decreasing puts the
+/// 1 liter in next to the 4 right away; FIFO keeps it behind the 3 that doesn't fit yet.
+bool testAirFryerAdmission() {
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    auto run = [](AirFryer::Admission admission) {
+        AirFryer air_fryer(5.f);
+        air_fryer.setAdmission(admission);
+        for (float volume : {4.f, 3.f, 1.f}) {
+            auto data = makeData(DeviceOpId::eAirFryerCook, volume, 10);
+            air_fryer.operate(&data);
+        }
+        air_fryer.timeTravel(0);
+        auto stats = air_fryer.getStats();
+        size_t no_space = 0;
+        size_t queued = 0;
+        for (const auto& record : air_fryer.getRecords()) {
+            no_space += record.event == OpEvent::eCookNoSpace;
+            queued += record.event == OpEvent::eCookQueued;
+        }
+        return std::tuple{stats, no_space, queued};
+    };
+    auto [ffd, ffd_no_space, ffd_queued] = run(AirFryer::Admission::eFirstFitDecreasing);
+    auto [fifo, fifo_no_space, fifo_queued] = run(AirFryer::Admission::eFifo);
+
+    bool ok = check(ffd.queued == 1, "FFD should queue only the 3 liters");
+    ok &= check(fifo.queued == 2, "FIFO should queue the 3 and the 1 liter");
+    ok &= check(ffd.pending == 0 && fifo.pending == 0, "AirFryer queue didn't drain");
+    ok &= check(ffd.cooked == 3 && fifo.cooked == 3, "AirFryer didn't cook every item");
+    ok &= check(ffd.max_wait_min == 10.f && fifo.max_wait_min == 10.f, "wrong longest wait");
+    ok &= check(ffd.mean_wait_min < fifo.mean_wait_min, "FFD should wait less than FIFO");
+    ok &= check(ffd_no_space == 1 && ffd_queued == 0, "FFD logged the wrong queue events");
+    // The 1 liter fits, so FIFO logs it as queued, not as out of space.
+    ok &= check(fifo_no_space == 1 && fifo_queued == 1, "FIFO logged the wrong queue events");
+    return ok;
+}
+
+/// @brief Each bad line is skipped on its own and counted; the good lines around it still load,
+/// including the other commands of a device that rejected one.
+bool testConfigErrors() {
+    constexpr std::string_view CONFIG = R"(# fryer
+device eAirFryer 3.0
+cmd eAirFryerCook eNormal 1.0 5 0
+cmd eSing                          # not an AirFryer op
+cmd eNoSuchOp
+cmd eAirFryerCook eNormal 1.0x 5   # not a number
+travel soon
+cmd eAirFryerCook eNormal 2.0 5 0
+device eNoSuchKind 1
+cmd eAirFryerCook eNormal 1.0 5 0  # no device to belong to
+device eDemoDevice ConfigBot
+nop
+travel 10
+)";
+    Device::loginRoom(std::make_shared<Room>(25.f));
+    SmartManager manager;
+    auto stats = Config::load(CONFIG, manager);
+    bool ok = check(stats.devices == 2, "config should load 2 devices");
+    ok &= check(stats.commands == 3, "config should load 3 commands");
+    ok &= check(stats.errors == 6, "config should skip 6 lines");
+    ok &= check(manager.getNumDevices() == 2, "SmartManager should have 2 devices");
+    ok &= check(!Config::loadFile(tempPath("no_such.cfg"), manager), "missing config loaded");
+    return ok;
+}
+
+/// @brief Restoring a checkpoint and saving it again gives the same file, so every device, running
+/// timer, queued job and pending command made it through. A truncated or foreign file restores
+/// nothing.
+bool testCheckpoint() {
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    auto saved_path = tempPath("test_smart_home.ckpt");
+    auto resaved_path = tempPath("test_smart_home_resaved.ckpt");
+    auto corrupt_path = tempPath("test_smart_home_corrupt.ckpt");
+
+    Device::loginRoom(std::make_shared<Room>(21.5f));
+    SmartManager manager;
+    auto air_fryer = std::make_shared<AirFryer>(5.f);
+    auto washer_dryer = std::make_shared<WasherDryer>(10.f, 4);
+    auto ac = std::make_shared<RealAC>(2000);
+    std::vector<std::string> names = {air_fryer->getName(), washer_dryer->getName(), ac->getName()};
+    for (float volume : {2.f, 2.f, 3.f}) {
+        auto data = makeData(DeviceOpId::eAirFryerCook, volume, 20);
+        air_fryer->operate(&data);
+    }
+    for (int minutes : {40, 30}) {
+        auto data = makeData(DeviceOpId::eWashDryerCombo, 5.f, minutes);
+        washer_dryer->operate(&data);
+    }
+    auto ac_data = makeData(DeviceOpId::eRealAcOpenForMins, 0.f, 30);
+    ac_data.dstring = "eMid";
+    ac->operate(&ac_data);
+    auto ac_id = *manager.addDevice(std::move(ac));
+    manager.addDevice(std::move(air_fryer));
+    manager.addDevice(std::move(washer_dryer));
+    manager.addSingleData(
+        ac_id, makeCommand(manager, DeviceOpId::eRealAcOpenForMins, 0.f, 10, true, "eLow")
+    );
+    manager.addTravleTime(ac_id, 15);
+    bool ok = check(manager.saveCheckpoint(saved_path), "saveCheckpoint() failed");
+
+    // A different room, so restoring has to bring the saved temperature back.
+    Device::loginRoom(std::make_shared<Room>(30.f));
+    SmartManager restored;
+    ok &= check(restored.restoreCheckpoint(saved_path), "restoreCheckpoint() failed");
+    ok &= check(restored.getNumDevices() == 3, "restored SmartManager should have 3 devices");
+    for (const auto& name : names) {
+        ok &= check(restored.findDevice(name).has_value(), "restored device lost its name");
+    }
+    ok &= check(Device::getRoom()->getTemp() == 21.5f, "room temperature not restored");
+    ok &= check(restored.saveCheckpoint(resaved_path), "saveCheckpoint() after restore failed");
+    auto saved = readFile(saved_path);
+    ok &= check(readFile(resaved_path) == saved, "checkpoint changed across a restore");
+
+    // Cut off the last byte, then break the magic: neither may restore anything.
+    for (size_t size : {saved.size() - 1, saved.size()}) {
+        auto corrupt = saved.substr(0, size);
+        if (size == saved.size())
+            corrupt[0] = 'X';
+        std::ofstream(corrupt_path, std::ios::binary) << corrupt;
+        SmartManager rejected;
+        ok &= check(!rejected.restoreCheckpoint(corrupt_path), "corrupt checkpoint restored");
+        ok &= check(rejected.getNumDevices() == 0, "corrupt checkpoint left devices behind");
+    }
+    for (const auto& path : {saved_path, resaved_path, corrupt_path}) {
+        std::filesystem::remove(path);
+    }
+    return ok;
+}
+
+/// @brief Record a session with a binary op log, then replay it into a fresh manager with its own
+/// op log. Both files must match byte for byte, string table included: restored devices intern
+/// their saved names only, so string ids don't shift.
+bool testRecordReplay() {
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    auto record_path = tempPath("test_smart_home.rec");
+    auto recorded_log = tempPath("test_smart_home_recorded.oplog");
+    auto replayed_log = tempPath("test_smart_home_replayed.oplog");
+
+    Device::loginRoom(std::make_shared<Room>(25.f));
+    {
+        SmartManager manager;
+        manager.setOpLog(recorded_log);
+        // Added before recording starts, so the replay restores it from the recorded state.
+        auto demo = *manager.addDevice(std::make_shared<DemoDevice>("Bot"));
+        manager.startRecording(record_path);
+        auto fryer = *manager.addDevice(std::make_shared<AirFryer>(3.f));
+        auto ac = *manager.addDevice(std::make_shared<RealAC>(1000));
+        for (int round = 0; round < 3; round++) {
+            manager.addSingleData(demo, makeCommand(manager, DeviceOpId::eHello));
+            manager.addSingleData(fryer, makeCommand(manager, DeviceOpId::eAirFryerCook, 2.f, 10));
+            manager.addSingleData(
+                ac, makeCommand(manager, DeviceOpId::eRealAcOpenForMins, 0.f, 5, true, "eLow")
+            );
+            for (auto id : {demo, fryer, ac}) {
+                manager.addTravleTime(id, 15);
+            }
+            manager.operate();
+        }
+        manager.stopRecording();
+        manager.closeOpLog();
+    }
+
+    Device::loginRoom(std::make_shared<Room>(25.f));
+    SmartManager replayed;
+    replayed.setOpLog(replayed_log);
+    bool ok = check(replayed.replay(record_path), "SmartManager::replay() failed");
+    replayed.closeOpLog();
+
+    auto recorded = readFile(recorded_log);
+    ok &= check(!recorded.empty(), "no op log recorded");
+    ok &= check(readFile(replayed_log) == recorded, "replayed op log differs from recorded one");
+    for (const auto& path : {record_path, recorded_log, replayed_log}) {
+        std::filesystem::remove(path);
+    }
+    return ok;
+}
+
+/// @brief A real op log reads back; corrupting its table offset or a string length makes
+/// `readOpLog()` fail cleanly instead of misreading records or allocating gigabytes.
+bool testOpLogCorrupt() {
+    SimClock::setTimeScale(TimeScale::K_AS_FAST_AS_POSSIBLE);
+    auto log_path = tempPath("test_smart_home.oplog");
+    auto corrupt_path = tempPath("test_smart_home_corrupt.oplog");
+    Device::loginRoom(std::make_shared<Room>(25.f));
+    {
+        SmartManager manager;
+        manager.setOpLog(log_path);
+        auto demo = *manager.addDevice(std::make_shared<DemoDevice>("LogBot"));
+        manager.addSingleData(demo, makeCommand(manager, DeviceOpId::eHello));
+        manager.operate();
+        manager.closeOpLog();
+    }
+    std::vector<OpRecord> records;
+    OpStringTable strings;
+    bool ok = check(readOpLog(log_path, records, strings), "readOpLog() failed");
+    ok &= check(!records.empty(), "readOpLog() read no records");
+
+    auto bytes = readFile(log_path);
+    uint64_t table_offset = 0;
+    size_t footer = bytes.size() - sizeof(table_offset);
+    std::memcpy(&table_offset, bytes.data() + footer, sizeof(table_offset));
+    auto corrupt = [&](size_t at, auto value) {
+        auto copy = bytes;
+        std::memcpy(copy.data() + at, &value, sizeof(value));
+        std::ofstream(corrupt_path, std::ios::binary) << copy;
+        std::vector<OpRecord> corrupt_records;
+        OpStringTable corrupt_strings;
+        return !readOpLog(corrupt_path, corrupt_records, corrupt_strings);
+    };
+    ok &= check(corrupt(footer, table_offset + 1), "table offset off the record grid accepted");
+    ok &= check(corrupt(footer, uint64_t{bytes.size()} * 2), "table offset past the end accepted");
+    // The first string's length, right after the count.
+    ok &= check(corrupt(table_offset + 4, uint32_t{0xFFFFFFF0}), "huge string length accepted");
+    ok &= check(corrupt(table_offset, uint32_t{0xFFFFFFF0}), "huge string count accepted");
+    for (const auto& path : {log_path, corrupt_path}) {
+        std::filesystem::remove(path);
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = testRoomAddTemp();
+    ok &= testConcurrentAcs();
+    ok &= testAcFleetMatchesRealAc();
+    ok &= testThermalGridKernels();
+    ok &= testEngineInterleavesDevices();
+    ok &= testWasherDryerFastForward();
+    ok &= testWasherDryerBinFull();
+    ok &= testAirFryerCooksConcurrently();
+    ok &= testAirFryerAdmission();
+    ok &= testConfigErrors();
+    ok &= testCheckpoint();
+    ok &= testRecordReplay();
+    ok &= testOpLogCorrupt();
+    Log::flush();
+    return ok ? 0 : 1;
+}